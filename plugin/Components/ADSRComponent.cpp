@@ -18,16 +18,19 @@ ADSRComponent::ADSRComponent(juce::AudioProcessorValueTreeState& apvts)
     decayAttachment = std::make_unique<sliderAttachment>(apvts, "decay", decaySlider);
     sustainAttachment = std::make_unique<sliderAttachment>(apvts, "sustain", sustainSlider);
     releaseAttachment = std::make_unique<sliderAttachment>(apvts, "release", releaseSlider);
+    curveAttachment = std::make_unique<sliderAttachment>(apvts, "curve", curveSlider);
 
     setStyle(attackSlider);
     setStyle(decaySlider); 
     setStyle(sustainSlider);
     setStyle(releaseSlider);
+    setStyle(curveSlider);
 
     addAndMakeVisible(attackSlider);
     addAndMakeVisible(decaySlider);
     addAndMakeVisible(sustainSlider);
     addAndMakeVisible(releaseSlider);
+    addAndMakeVisible(curveSlider);
 }
 
 ADSRComponent::~ADSRComponent()
@@ -44,13 +47,14 @@ void ADSRComponent::resized()
     auto padding = 10;
     auto area = getLocalBounds().reduced(padding);
 
-    int numComponents = 4;
+    int numComponents = 5;
     auto componentWidth = (area.getWidth() - (numComponents) * padding) / numComponents;
 
     attackSlider.setBounds(area.removeFromLeft(componentWidth).reduced(padding));
     decaySlider.setBounds(area.removeFromLeft(componentWidth).reduced(padding));
     sustainSlider.setBounds(area.removeFromLeft(componentWidth).reduced(padding));
     releaseSlider.setBounds(area.removeFromLeft(componentWidth).reduced(padding));
+    curveSlider.setBounds(area.removeFromLeft(componentWidth).reduced(padding));
 }
 
 void ADSRComponent::setStyle(juce::Slider& slider)
@@ -22,7 +22,7 @@ public:
     void resized() override;
 
 private:
-    juce::Slider attackSlider, decaySlider, sustainSlider, releaseSlider;
+    juce::Slider attackSlider, decaySlider, sustainSlider, releaseSlider, curveSlider;
 
     using sliderAttachment = juce::AudioProcessorValueTreeState::SliderAttachment;
 
@@ -30,6 +30,7 @@ private:
     std::unique_ptr<sliderAttachment> decayAttachment;
     std::unique_ptr<sliderAttachment> sustainAttachment;
     std::unique_ptr<sliderAttachment> releaseAttachment;
+    std::unique_ptr<sliderAttachment> curveAttachment;
 
     void setStyle(juce::Slider& slider);
 
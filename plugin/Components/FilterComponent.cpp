@@ -16,6 +16,7 @@ FilterComponent::FilterComponent(juce::AudioProcessorValueTreeState& apvts)
     cutoffAttachment = std::make_unique<sliderAttachment>(apvts, "filterCutoff", cutoffSlider);
     resonanceAttachment = std::make_unique<sliderAttachment>(apvts, "filterResonance", resonanceSlider);
     filterModeAttachment = std::make_unique<comboBoxAttachment>(apvts, "filterMode", filterModeComboBox);
+    morphAttachment = std::make_unique<sliderAttachment>(apvts, "filterMorph", morphSlider);
     adsrFilterAmountAttachment = std::make_unique<sliderAttachment>(apvts, "adsrFilterAmount", adsrFilterAmountSlider);
 
     setStyle(cutoffSlider);
@@ -26,6 +27,10 @@ FilterComponent::FilterComponent(juce::AudioProcessorValueTreeState& apvts)
     resonanceSlider.setTextValueSuffix(" dB");
     addAndMakeVisible(resonanceSlider);
 
+    // Low pass (0) to band pass (1), high pass (2) and notch (3), for the state-variable filter
+    setStyle(morphSlider);
+    addAndMakeVisible(morphSlider);
+
     setStyle(adsrFilterAmountSlider);
     adsrFilterAmountSlider.setTextValueSuffix(" %");
     addAndMakeVisible(adsrFilterAmountSlider);
@@ -40,6 +45,39 @@ FilterComponent::FilterComponent(juce::AudioProcessorValueTreeState& apvts)
     filterModeComboBox.setSelectedId(2); // Default to LPF 24dB
     addAndMakeVisible(filterModeComboBox);
 
+    // Set up filter type combo box (the items need to exist before the attachment)
+    filterTypeComboBox.addItem("Ladder", 1);
+    filterTypeComboBox.addItem("State Variable", 2);
+    filterTypeAttachment = std::make_unique<comboBoxAttachment>(apvts, "filterType", filterTypeComboBox);
+    addAndMakeVisible(filterTypeComboBox);
+
+    // Set up the second filter, its routing and mode items added before the attachments as well
+    filter2CutoffAttachment = std::make_unique<sliderAttachment>(apvts, "filter2Cutoff", filter2CutoffSlider);
+    filter2ResonanceAttachment = std::make_unique<sliderAttachment>(apvts, "filter2Resonance", filter2ResonanceSlider);
+
+    setStyle(filter2CutoffSlider);
+    filter2CutoffSlider.setTextValueSuffix(" Hz");
+    addAndMakeVisible(filter2CutoffSlider);
+
+    setStyle(filter2ResonanceSlider);
+    filter2ResonanceSlider.setTextValueSuffix(" dB");
+    addAndMakeVisible(filter2ResonanceSlider);
+
+    filter2RoutingComboBox.addItem("Filter 2 Off", 1);
+    filter2RoutingComboBox.addItem("Serial", 2);
+    filter2RoutingComboBox.addItem("Parallel", 3);
+    filter2RoutingAttachment = std::make_unique<comboBoxAttachment>(apvts, "filter2Routing", filter2RoutingComboBox);
+    addAndMakeVisible(filter2RoutingComboBox);
+
+    filter2ModeComboBox.addItem("LPF 12dB", 1);
+    filter2ModeComboBox.addItem("LPF 24dB", 2);
+    filter2ModeComboBox.addItem("HPF 12dB", 3);
+    filter2ModeComboBox.addItem("HPF 24dB", 4);
+    filter2ModeComboBox.addItem("BPF 12dB", 5);
+    filter2ModeComboBox.addItem("BPF 24dB", 6);
+    filter2ModeAttachment = std::make_unique<comboBoxAttachment>(apvts, "filter2Mode", filter2ModeComboBox);
+    addAndMakeVisible(filter2ModeComboBox);
+
     // Set up ADSR button
     adsrToggleButton.setButtonText("ADSR");
     adsrToggleButton.setClickingTogglesState(true); // Make it a toggle button
@@ -83,16 +121,18 @@ void FilterComponent::resized()
     auto area = getLocalBounds();
     auto padding = 5;
     
-    // Filter mode combo box at the top
-    filterModeComboBox.setBounds(area.removeFromTop(30).reduced(padding));
+    // Filter type and mode combo boxes at the top
+    auto comboBoxArea = area.removeFromTop(30);
+    filterTypeComboBox.setBounds(comboBoxArea.removeFromLeft(comboBoxArea.getWidth() / 2).reduced(padding));
+    filterModeComboBox.setBounds(comboBoxArea.reduced(padding));
     area.removeFromTop(padding);
     
-    // Main controls section (cutoff and resonance)
+    // Main controls section (cutoff, resonance and morph)
     auto mainControlsHeight = 120;
     auto mainControlsArea = area.removeFromTop(mainControlsHeight);
     
     // Split main controls horizontally
-    auto knobWidth = (mainControlsArea.getWidth() - 3 * padding) / 2;
+    auto knobWidth = (mainControlsArea.getWidth() - 4 * padding) / 3;
     
     // Cutoff slider (left)
     auto cutoffArea = mainControlsArea.removeFromLeft(knobWidth);
@@ -103,8 +143,12 @@ void FilterComponent::resized()
     // Add horizontal spacing
     mainControlsArea.removeFromLeft(padding);
     
-    // Resonance slider (right)
-    resonanceSlider.setBounds(mainControlsArea.reduced(padding));
+    // Resonance slider (middle)
+    resonanceSlider.setBounds(mainControlsArea.removeFromLeft(knobWidth).reduced(padding));
+    mainControlsArea.removeFromLeft(padding);
+
+    // Morph slider (right)
+    morphSlider.setBounds(mainControlsArea.reduced(padding));
     
     // Add vertical spacing
     area.removeFromTop(padding);
@@ -122,6 +166,21 @@ void FilterComponent::resized()
     adsrArea.removeFromLeft(padding);
     filterReleaseSlider.setBounds(adsrArea.removeFromLeft(adsrSliderWidth).reduced(padding));
     adsrFilterAmountSlider.setBounds(adsrArea.reduced(padding));
+
+    // Add vertical spacing
+    area.removeFromTop(padding);
+
+    // Second filter section: routing and mode on the left, cutoff and resonance beside them
+    auto filter2Area = area.removeFromTop(90);
+    auto filter2KnobWidth = (filter2Area.getWidth() - 2 * padding) / 3;
+    auto filter2ComboBoxArea = filter2Area.removeFromLeft(filter2KnobWidth);
+
+    filter2RoutingComboBox.setBounds(filter2ComboBoxArea.removeFromTop(30).reduced(padding));
+    filter2ModeComboBox.setBounds(filter2ComboBoxArea.removeFromTop(30).reduced(padding));
+    filter2Area.removeFromLeft(padding);
+    filter2CutoffSlider.setBounds(filter2Area.removeFromLeft(filter2KnobWidth).reduced(padding));
+    filter2Area.removeFromLeft(padding);
+    filter2ResonanceSlider.setBounds(filter2Area.reduced(padding));
 }
 
 FilterComponent::~FilterComponent()
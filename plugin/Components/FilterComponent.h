@@ -22,8 +22,12 @@ public:
     void resized() override;
 
 private:
-    juce::Slider cutoffSlider, resonanceSlider;
-    juce::ComboBox filterModeComboBox;
+    juce::Slider cutoffSlider, resonanceSlider, morphSlider;
+    juce::ComboBox filterModeComboBox, filterTypeComboBox;
+
+    // Second filter of the voice, off or in series or parallel with the first
+    juce::Slider filter2CutoffSlider, filter2ResonanceSlider;
+    juce::ComboBox filter2RoutingComboBox, filter2ModeComboBox;
     
     // ADSR sliders for filter envelope
     juce::Slider filterAttackSlider, filterDecaySlider, filterSustainSlider, filterReleaseSlider;
@@ -35,6 +39,12 @@ private:
     std::unique_ptr<sliderAttachment> cutoffAttachment;
     std::unique_ptr<sliderAttachment> resonanceAttachment;
     std::unique_ptr<comboBoxAttachment> filterModeAttachment;
+    std::unique_ptr<sliderAttachment> morphAttachment;
+    std::unique_ptr<comboBoxAttachment> filterTypeAttachment;
+    std::unique_ptr<sliderAttachment> filter2CutoffAttachment;
+    std::unique_ptr<sliderAttachment> filter2ResonanceAttachment;
+    std::unique_ptr<comboBoxAttachment> filter2RoutingAttachment;
+    std::unique_ptr<comboBoxAttachment> filter2ModeAttachment;
     
     // ADSR attachments
     std::unique_ptr<sliderAttachment> filterAttackAttachment;
@@ -36,6 +36,19 @@ OscillatorComponent::OscillatorComponent(juce::AudioProcessorValueTreeState& apv
     osc3ToggleButton.setClickingTogglesState(true); // Make it a toggle
     osc3ToggleAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(apvts, "osc3Enabled", osc3ToggleButton);
     addAndMakeVisible(osc3ToggleButton);
+
+    // Wavetable file buttons
+    osc1LoadButton.setButtonText("Load WT");
+    osc1LoadButton.onClick = [this] { chooseWavetable(1); };
+    addAndMakeVisible(osc1LoadButton);
+
+    osc2LoadButton.setButtonText("Load WT");
+    osc2LoadButton.onClick = [this] { chooseWavetable(2); };
+    addAndMakeVisible(osc2LoadButton);
+
+    osc3LoadButton.setButtonText("Load WT");
+    osc3LoadButton.onClick = [this] { chooseWavetable(3); };
+    addAndMakeVisible(osc3LoadButton);
 }
 
 OscillatorComponent::~OscillatorComponent()
@@ -58,6 +71,7 @@ void OscillatorComponent::resized()
 
     auto left = area.removeFromLeft(componentWidth);
     auto right = area.removeFromRight(componentWidth);
+    auto middle = area.reduced(padding, 0);
 
     osc1ToggleButton.setBounds(left.removeFromTop(size));
     left.removeFromTop(padding);
@@ -70,6 +84,12 @@ void OscillatorComponent::resized()
     waveformSelector2.setBounds(right.removeFromTop(size));
     right.removeFromTop(padding);
     waveformSelector3.setBounds(right.removeFromTop(size));
+
+    osc1LoadButton.setBounds(middle.removeFromTop(size));
+    middle.removeFromTop(padding);
+    osc2LoadButton.setBounds(middle.removeFromTop(size));
+    middle.removeFromTop(padding);
+    osc3LoadButton.setBounds(middle.removeFromTop(size));
 }
 
 void OscillatorComponent::setLabels(juce::ComboBox& box)
@@ -79,6 +99,32 @@ void OscillatorComponent::setLabels(juce::ComboBox& box)
     box.addItem("Saw", 3);
     box.addItem("Triangle", 4);
     box.addItem("Noise", 5);
+    box.addItem("Pink Noise", 6);
+    box.addItem("Brown Noise", 7);
+    box.addItem("Wavetable", 8);
+    box.addItem("Additive", 9);
     box.setSelectedId(1); // Default to Sine
     addAndMakeVisible(box);
-}
\ No newline at end of file
+}
+
+void OscillatorComponent::chooseWavetable(const int oscIndex)
+{
+    fileChooser = std::make_unique<juce::FileChooser>("Load a wavetable", juce::File(), "*.wav");
+
+    fileChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+        [this, oscIndex](const juce::FileChooser& chooser)
+        {
+            const auto file = chooser.getResult();
+
+            if (file == juce::File() || onWavetableChosen == nullptr)
+                return;
+
+            auto& button = oscIndex == 1 ? osc1LoadButton : (oscIndex == 2 ? osc2LoadButton : osc3LoadButton);
+
+            if (onWavetableChosen(oscIndex, file))
+                button.setButtonText(file.getFileNameWithoutExtension());
+            else
+                juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon, "Load Wavetable",
+                    file.getFileName() + " isn't a WAV file of 2048-sample frames or a single cycle.");
+        });
+}
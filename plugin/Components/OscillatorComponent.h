@@ -21,7 +21,12 @@ public:
     void paint(juce::Graphics&) override;
     void resized() override;
     void setLabels(juce::ComboBox& box);
+
+    // Called with the oscillator (1-based) and the file picked with its Load button, returns false
+    // if the file couldn't be used
+    std::function<bool(int, const juce::File&)> onWavetableChosen;
 private:
+    void chooseWavetable(const int oscIndex);
     
     using comboBoxAttachment = juce::AudioProcessorValueTreeState::ComboBoxAttachment;
     using buttonAttachment = juce::AudioProcessorValueTreeState::ButtonAttachment;
@@ -42,5 +47,10 @@ private:
     std::unique_ptr<buttonAttachment> osc2ToggleAttachment;
     std::unique_ptr<buttonAttachment> osc3ToggleAttachment;
 
+    juce::TextButton osc1LoadButton;
+    juce::TextButton osc2LoadButton;
+    juce::TextButton osc3LoadButton;
+    std::unique_ptr<juce::FileChooser> fileChooser;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OscillatorComponent)
 };
\ No newline at end of file
@@ -196,6 +196,31 @@ public:
         }
     }
 
+    // Same as process() for a block of zeros, without having to look at the samples
+    void processSilence (size_t numSamples)
+    {
+        if (numSamples == 0)
+            return;
+
+        // Silence never crosses the trigger level, it only becomes the previous sample
+        if (state == State::waitingForTrigger)
+        {
+            prevSample = SampleType (0);
+            return;
+        }
+
+        const auto numToFill = juce::jmin (numSamples, buffer.size() - numCollected);
+        std::fill (buffer.begin() + (std::ptrdiff_t) numCollected, buffer.begin() + (std::ptrdiff_t) (numCollected + numToFill), SampleType (0));
+        numCollected += numToFill;
+
+        if (numCollected == buffer.size())
+        {
+            audioBufferQueue.push (buffer.data(), buffer.size());
+            state = State::waitingForTrigger;
+            prevSample = SampleType (100);
+        }
+    }
+
 private:
     //==============================================================================
     AudioBufferQueue<SampleType>& audioBufferQueue;
@@ -10,35 +10,302 @@
 
 #include "ADSRData.h"
 
+namespace
+{
+    constexpr double minCurveRatio = 0.0001; // Overshoot of the most curved stages, which stop within -80 dB of their asymptote
+    constexpr double attackCurveRatio = 0.3; // The attack charges towards a point further out, so it is the gentler curve
+
+    // How far past its end a curved stage aims, as a share of the stage's height
+    double getCurveRatio(const float curve) noexcept
+    {
+        return (1.0 - curve) / curve + minCurveRatio;
+    }
+}
+
 ADSRData::ADSRData()
 {
     // Initialize with default ADSR values
-    setParameters(juce::ADSR::Parameters{
-        0.1f,  // attack
-        0.2f,  // decay  
-        0.7f,  // sustain
-        0.3f   // release
-    });
+    updateEnvelope(0.1f,  // attack
+                   0.2f,  // decay
+                   0.7f,  // sustain
+                   0.3f,  // release
+                   0.0f); // curve
 }
 
-void ADSRData::prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels)
+void ADSRData::prepareToPlay(double newSampleRate, int samplesPerBlock, int numChannels)
 {
-        // Initialize with default envelope parameters
-    envelopeParams.attack = 0.1f;
-    envelopeParams.decay = 0.2f;
-    envelopeParams.sustain = 0.7f;
-    envelopeParams.release = 0.3f;
-    setParameters(envelopeParams);
+    juce::ignoreUnused(samplesPerBlock, numChannels);
+    setSampleRate(newSampleRate);
+
+    // Initialize with default envelope parameters
+    updateEnvelope(0.1f, 0.2f, 0.7f, 0.3f, 0.0f);
 }
 
-void ADSRData::updateEnvelope(const float attack, const float decay, const float sustain, const float release)
+void ADSRData::updateEnvelope(const float attack, const float decay, const float sustain, const float release, const float newCurve)
 {
+    jassert(sustain >= 0.0f && sustain <= 1.0f);
+
+    // Called every block with the same values, the segments only have to be redone on a change
+    if (attack == envelopeParams.attack && decay == envelopeParams.decay && sustain == envelopeParams.sustain
+        && release == envelopeParams.release && newCurve == curve)
+        return;
+
     // Set more reasonable envelope parameters
     envelopeParams.attack = attack;
     envelopeParams.decay = decay;
     envelopeParams.sustain = sustain;
     envelopeParams.release = release;
+    curve = juce::jlimit(0.0f, 1.0f, newCurve);
+
+    recalculateSegments();
+}
+
+void ADSRData::setSampleRate(const double newSampleRate)
+{
+    jassert(newSampleRate > 0.0);
+
+    if (newSampleRate == sampleRate)
+        return;
+
+    sampleRate = newSampleRate;
+    recalculateSegments();
+}
+
+void ADSRData::reset() noexcept
+{
+    envelopeVal = 0.0;
+    state = State::idle;
+}
+
+void ADSRData::noteOn() noexcept
+{
+    if (attackSegment.moves())
+    {
+        state = State::attack;
+    }
+    else if (decaySegment.moves())
+    {
+        envelopeVal = 1.0f;
+        state = State::decay;
+    }
+    else
+    {
+        envelopeVal = envelopeParams.sustain;
+        state = State::sustain;
+    }
+}
+
+void ADSRData::noteOff() noexcept
+{
+    if (state == State::idle)
+        return;
+
+    // The release takes its time from wherever the envelope is
+    releaseSegment = makeSegment(envelopeVal, 0.0, envelopeParams.release, releaseCoefficient, releaseRatio);
+
+    if (releaseSegment.moves())
+        state = State::release;
+    else
+        reset();
+}
+
+double ADSRData::getCoefficient(const float seconds, const double ratio) const noexcept
+{
+    const double samples = seconds * sampleRate;
+
+    if (curve <= 0.0f || samples <= 0.0)
+        return 0.0;
+
+    // Over the stage's length the distance to the asymptote shrinks from (1 + ratio) to ratio
+    // times its height. Kept as 1 - decay per sample, which holds its precision however close
+    // to 1 the decay gets for long, nearly straight stages.
+    return -std::expm1(-std::log((1.0 + ratio) / ratio) / samples);
+}
+
+ADSRData::Segment ADSRData::makeSegment(const double start, const double end, const float seconds, const double coefficient, const double ratio) const noexcept
+{
+    Segment segment;
+
+    if (seconds <= 0.0f || start == end)
+        return segment;
+
+    if (coefficient > 0.0)
+    {
+        segment.coefficient = coefficient;
+        segment.asymptote = end + (end - start) * ratio;
+        segment.logDecay = std::log1p(-coefficient);
+    }
+    else
+    {
+        segment.rate = (end - start) / (seconds * sampleRate);
+    }
+
+    return segment;
+}
+
+void ADSRData::recalculateSegments() noexcept
+{
+    const double ratio = curve > 0.0f ? getCurveRatio(curve) : 0.0;
+    const double attackRatio = ratio + attackCurveRatio;
+
+    // The attack always covers the full height and the decay starts from the top. The release is
+    // laid out again by noteOff, or here if the release time changes while the note is let go.
+    attackSegment = makeSegment(0.0, 1.0, envelopeParams.attack, getCoefficient(envelopeParams.attack, attackRatio), attackRatio);
+    decaySegment = makeSegment(1.0, envelopeParams.sustain, envelopeParams.decay, getCoefficient(envelopeParams.decay, ratio), ratio);
+    releaseCoefficient = getCoefficient(envelopeParams.release, ratio);
+    releaseRatio = ratio;
 
-    // Update the envelope parameters
-    setParameters(envelopeParams);
-}
\ No newline at end of file
+    if (state == State::release)
+        releaseSegment = makeSegment(envelopeVal, 0.0, envelopeParams.release, releaseCoefficient, releaseRatio);
+
+    if ((state == State::attack && !attackSegment.moves())
+        || (state == State::decay && (!decaySegment.moves() || envelopeVal <= envelopeParams.sustain))
+        || (state == State::release && !releaseSegment.moves()))
+    {
+        goToNextState();
+    }
+}
+
+void ADSRData::goToNextState() noexcept
+{
+    if (state == State::attack)
+        state = decaySegment.moves() ? State::decay : State::sustain;
+    else if (state == State::decay)
+        state = State::sustain;
+    else if (state == State::release)
+        reset();
+}
+
+const ADSRData::Segment* ADSRData::getSegment() const noexcept
+{
+    switch (state)
+    {
+    case State::attack:
+        return &attackSegment;
+    case State::decay:
+        return &decaySegment;
+    case State::release:
+        return &releaseSegment;
+    case State::idle:
+    case State::sustain:
+    default:
+        return nullptr;
+    }
+}
+
+double ADSRData::getSegmentEnd() const noexcept
+{
+    if (state == State::attack)
+        return 1.0;
+
+    return state == State::decay ? envelopeParams.sustain : 0.0;
+}
+
+int ADSRData::getSegmentLength() const noexcept
+{
+    const Segment* segment = getSegment();
+
+    if (segment == nullptr)
+        return std::numeric_limits<int>::max();
+
+    // Samples to the end, rounded up: the sample that reaches or passes it is the last one, as in
+    // juce::ADSR::getNextSample. A curve's distance to its asymptote shrinks geometrically.
+    const double end = getSegmentEnd();
+    const double samples = segment->isCurved()
+        ? std::log((end - segment->asymptote) / (envelopeVal - segment->asymptote)) / segment->logDecay
+        : (end - envelopeVal) / segment->rate;
+
+    return static_cast<int>(juce::jlimit(1.0, static_cast<double>(std::numeric_limits<int>::max()), std::ceil(samples)));
+}
+
+void ADSRData::step(const int numSamples) noexcept
+{
+    const int segmentLength = getSegmentLength();
+    jassert(numSamples <= segmentLength);
+
+    if (numSamples < segmentLength)
+    {
+        if (const Segment* segment = getSegment())
+        {
+            if (segment->isCurved())
+                envelopeVal = segment->asymptote + (envelopeVal - segment->asymptote) * std::exp(segment->logDecay * numSamples);
+            else
+                envelopeVal += segment->rate * numSamples;
+        }
+        else if (state == State::sustain)
+        {
+            envelopeVal = envelopeParams.sustain;
+        }
+
+        return;
+    }
+
+    // Landing on the end of the segment: attack and decay stop exactly on their target
+    if (state == State::attack)
+        envelopeVal = 1.0;
+    else if (state == State::decay)
+        envelopeVal = envelopeParams.sustain;
+
+    goToNextState();
+}
+
+void ADSRData::render(float* dest, const int numSamples) noexcept
+{
+    int done = 0;
+
+    while (done < numSamples)
+    {
+        const int length = juce::jmin(getSegmentLength(), numSamples - done);
+        const Segment* segment = getSegment();
+
+        if (segment == nullptr)
+        {
+            // The sustain level is read every sample, so a change to it is heard right away
+            const float level = state == State::idle ? 0.0f : envelopeParams.sustain;
+            juce::FloatVectorOperations::fill(dest + done, level, length);
+        }
+        else if (segment->isCurved())
+        {
+            // One multiply per sample
+            const double asymptote = segment->asymptote;
+            const double coefficient = segment->coefficient;
+            double value = envelopeVal;
+
+            for (int i = 0; i < length; ++i)
+            {
+                value += (asymptote - value) * coefficient;
+                dest[done + i] = static_cast<float>(value);
+            }
+        }
+        else
+        {
+            // A ramp in closed form
+            const auto start = static_cast<float>(envelopeVal);
+            const auto rate = static_cast<float>(segment->rate);
+
+            for (int i = 0; i < length; ++i)
+                dest[done + i] = start + rate * static_cast<float>(i + 1);
+        }
+
+        // The last sample is left to step, which clamps it to the segment's end (and to 0 after a
+        // release) exactly like the per-sample version
+        step(length);
+        dest[done + length - 1] = static_cast<float>(envelopeVal);
+        done += length;
+    }
+}
+
+float ADSRData::advance(const int numSamples) noexcept
+{
+    // At most attack, decay and then sustain (or release and then idle) get crossed
+    int remaining = numSamples;
+
+    while (remaining > 0)
+    {
+        const int length = juce::jmin(getSegmentLength(), remaining);
+        step(length);
+        remaining -= length;
+    }
+
+    return static_cast<float>(envelopeVal);
+}
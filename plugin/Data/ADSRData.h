@@ -12,14 +12,80 @@
 
 #include <JuceHeader.h>
 
-class ADSRData : public juce::ADSR
+// An ADSR with the same parameters, segments and state changes as juce::ADSR, but worked out a
+// segment at a time instead of a sample at a time. With no curve the segments are straight lines,
+// rendered as closed-form ramps (a flat loop the compiler vectorises). With a curve they are
+// RC-style exponentials, one multiply per sample. advance skips any number of samples in
+// constant time either way, for control-rate users that only need every Nth value.
+class ADSRData
 {
 public:
     ADSRData();
     void prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels);
-    void updateEnvelope(const float attack, const float decay, const float sustain, const float release);
 
+    // curve goes from 0 (straight lines) to 1 (fully exponential). Only changes are worked out.
+    void updateEnvelope(const float attack, const float decay, const float sustain, const float release, const float curve);
+
+    void setSampleRate(const double newSampleRate);
+
+    // Back to idle at 0
+    void reset() noexcept;
+    void noteOn() noexcept;
+    void noteOff() noexcept;
+
+    bool isActive() const noexcept { return state != State::idle; }
+
+    // Writes the next numSamples values to dest
+    void render(float* dest, const int numSamples) noexcept;
+
+    // Moves numSamples on and returns the value there, the last one render would have written
+    float advance(const int numSamples) noexcept;
+    float getNextSample() noexcept { return advance(1); }
 
 private:
+    enum class State { idle, attack, decay, sustain, release };
+
+    // A stage of the envelope. A straight line steps by rate every sample. A curve heads for an
+    // asymptote past the stage's end, like a capacitor charging towards a voltage it never
+    // reaches, closing coefficient of the distance every sample, and stops at the end. In double:
+    // a long, gentle curve moves the value by less than a float can resolve next to its asymptote.
+    struct Segment
+    {
+        double rate = 0.0;
+        double coefficient = 0.0;
+        double asymptote = 0.0;
+        double logDecay = 0.0; // log(1 - coefficient), for advancing a curve in closed form
+
+        bool isCurved() const noexcept { return coefficient > 0.0; }
+        bool moves() const noexcept { return isCurved() || rate != 0.0; }
+    };
+
+    // Coefficient of a curved stage that takes the given time, 0 for a straight line
+    double getCoefficient(const float seconds, const double ratio) const noexcept;
+    Segment makeSegment(const double start, const double end, const float seconds, const double coefficient, const double ratio) const noexcept;
+
+    void recalculateSegments() noexcept;
+    void goToNextState() noexcept;
+
+    // The current state's segment and where it ends, nullptr for idle and sustain
+    const Segment* getSegment() const noexcept;
+    double getSegmentEnd() const noexcept;
+
+    // Samples until the state changes, at least 1 (the sample that lands on the end), or
+    // std::numeric_limits<int>::max() for the states that only change on a note event
+    int getSegmentLength() const noexcept;
+
+    // Moves numSamples (no more than the segment length) along the current state
+    void step(const int numSamples) noexcept;
+
     juce::ADSR::Parameters envelopeParams; // Parameters for the envelope
+    float curve = 0.0f;
+    double sampleRate = 44100.0;
+    State state = State::idle;
+    double envelopeVal = 0.0;
+
+    // Worked out when the parameters or the sample rate change. The release coefficient is kept
+    // for noteOff, which starts the release from wherever the envelope is.
+    Segment attackSegment, decaySegment, releaseSegment;
+    double releaseCoefficient = 0.0, releaseRatio = 0.0;
 };
@@ -0,0 +1,140 @@
+/*
+  ==============================================================================
+
+    AnalyticOscillator.h
+    Created: 17 Oct 2026 4:08:13pm
+    Author:  max
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FastMath.h"
+
+// Naive waveforms with polynomial band-limited corrections (PolyBLEP for the jumps of
+// square and saw, PolyBLAMP for the corners of the triangle), evaluated for a whole
+// SIMD register of voices at once. Points is the width of the correction: 2 samples
+// (one either side of the discontinuity) or 4 (two either side, smoother and less aliased).
+//
+// Every shape takes the phase p (0..1), the phase increment dt and its inverse, and
+// matches the old lambda for that waveform at t = p - 0.5.
+namespace AnalyticOscillator
+{
+    using SIMDFloat = juce::dsp::SIMDRegister<float>;
+
+    // Signed distance in samples from the discontinuity at phase 'position' to p,
+    // wrapped to the nearer of the discontinuities before and after p
+    inline SIMDFloat distanceInSamples(const SIMDFloat p, const float position, const SIMDFloat inverseDelta) noexcept
+    {
+        auto u = p - SIMDFloat::expand(position);
+        u += SIMDFloat::expand(1.0f) & SIMDFloat::lessThan(u, SIMDFloat::expand(0.0f));
+
+        const auto secondHalf = SIMDFloat::greaterThanOrEqual(u, SIMDFloat::expand(0.5f));
+        u -= SIMDFloat::expand(1.0f) & secondHalf;
+        return u * inverseDelta;
+    }
+
+    // Band-limited step minus naive step, for an upward step of 1 at x = 0 (x in samples)
+    template <int Points>
+    inline SIMDFloat blepResidual(const SIMDFloat x) noexcept
+    {
+        const auto a = SIMDFloat::abs(x);
+        const auto before = SIMDFloat::lessThan(x, SIMDFloat::expand(0.0f));
+        SIMDFloat r;
+
+        if constexpr (Points == 2)
+        {
+            // Integrated linear (triangle) kernel
+            const auto w = SIMDFloat::max(SIMDFloat::expand(1.0f) - a, SIMDFloat::expand(0.0f));
+            r = w * w * 0.5f;
+        }
+        else
+        {
+            // Integrated cubic B-spline kernel
+            const auto w = SIMDFloat::max(SIMDFloat::expand(2.0f) - a, SIMDFloat::expand(0.0f));
+            const auto w2 = w * w;
+            const auto outer = w2 * w2 * (1.0f / 24.0f);
+
+            auto inner = SIMDFloat::expand(-1.0f / 8.0f);
+            inner = SIMDFloat::multiplyAdd(SIMDFloat::expand(1.0f / 3.0f), inner, a);
+            inner = SIMDFloat::multiplyAdd(SIMDFloat::expand(0.0f), inner, a);
+            inner = SIMDFloat::multiplyAdd(SIMDFloat::expand(-2.0f / 3.0f), inner, a);
+            inner = SIMDFloat::multiplyAdd(SIMDFloat::expand(0.5f), inner, a);
+
+            const auto inside = SIMDFloat::lessThan(a, SIMDFloat::expand(1.0f));
+            r = (inner & inside) + (outer & ~inside);
+        }
+
+        // The residual is odd: positive before the step, negative after it
+        return (r & before) - (r & ~before);
+    }
+
+    // Integral of blepResidual, for a slope change of 1 per sample at x = 0
+    template <int Points>
+    inline SIMDFloat blampResidual(const SIMDFloat x) noexcept
+    {
+        const auto a = SIMDFloat::abs(x);
+
+        if constexpr (Points == 2)
+        {
+            const auto w = SIMDFloat::max(SIMDFloat::expand(1.0f) - a, SIMDFloat::expand(0.0f));
+            return w * w * w * (1.0f / 6.0f);
+        }
+        else
+        {
+            const auto w = SIMDFloat::max(SIMDFloat::expand(2.0f) - a, SIMDFloat::expand(0.0f));
+            const auto w2 = w * w;
+            const auto outer = w2 * w2 * w * (1.0f / 120.0f);
+
+            auto inner = SIMDFloat::expand(1.0f / 40.0f);
+            inner = SIMDFloat::multiplyAdd(SIMDFloat::expand(-1.0f / 12.0f), inner, a);
+            inner = SIMDFloat::multiplyAdd(SIMDFloat::expand(0.0f), inner, a);
+            inner = SIMDFloat::multiplyAdd(SIMDFloat::expand(1.0f / 3.0f), inner, a);
+            inner = SIMDFloat::multiplyAdd(SIMDFloat::expand(-0.5f), inner, a);
+            inner = SIMDFloat::multiplyAdd(SIMDFloat::expand(7.0f / 30.0f), inner, a);
+
+            const auto inside = SIMDFloat::lessThan(a, SIMDFloat::expand(1.0f));
+            return (inner & inside) + (outer & ~inside);
+        }
+    }
+
+    // sin(2pi t), the high accuracy polynomial is within ~1e-7 over the whole cycle (no corrections needed)
+    inline SIMDFloat sine(const SIMDFloat p, const SIMDFloat, const SIMDFloat) noexcept
+    {
+        return FastMath::sin2pi<FastMath::Accuracy::high>(p - SIMDFloat::expand(0.5f));
+    }
+
+    // -1 for the first half of the cycle, +1 for the second: steps of -2 at 0 and +2 at 0.5
+    template <int Points>
+    inline SIMDFloat square(const SIMDFloat p, const SIMDFloat, const SIMDFloat inverseDelta) noexcept
+    {
+        const auto firstHalf = SIMDFloat::lessThan(p, SIMDFloat::expand(0.5f));
+        auto value = (SIMDFloat::expand(-1.0f) & firstHalf) + (SIMDFloat::expand(1.0f) & ~firstHalf);
+
+        value -= blepResidual<Points>(distanceInSamples(p, 0.0f, inverseDelta)) * 2.0f;
+        value += blepResidual<Points>(distanceInSamples(p, 0.5f, inverseDelta)) * 2.0f;
+        return value;
+    }
+
+    // Rising ramp from -1 to 1, with a step of -2 at 0
+    template <int Points>
+    inline SIMDFloat saw(const SIMDFloat p, const SIMDFloat, const SIMDFloat inverseDelta) noexcept
+    {
+        const auto value = p * 2.0f - SIMDFloat::expand(1.0f);
+        return value - blepResidual<Points>(distanceInSamples(p, 0.0f, inverseDelta)) * 2.0f;
+    }
+
+    // 1 at 0, -1 at 0.5: the slope jumps by -8 per cycle at 0 and by +8 at 0.5
+    template <int Points>
+    inline SIMDFloat triangle(const SIMDFloat p, const SIMDFloat delta, const SIMDFloat inverseDelta) noexcept
+    {
+        const auto value = SIMDFloat::abs(p - SIMDFloat::expand(0.5f)) * 4.0f - SIMDFloat::expand(1.0f);
+        const auto slopeChange = delta * 8.0f; // Per sample
+
+        const auto corners = blampResidual<Points>(distanceInSamples(p, 0.5f, inverseDelta))
+                           - blampResidual<Points>(distanceInSamples(p, 0.0f, inverseDelta));
+        return SIMDFloat::multiplyAdd(value, slopeChange, corners);
+    }
+}
@@ -0,0 +1,24 @@
+/*
+  ==============================================================================
+
+    CutoffTable.cpp
+    Created: 18 Oct 2026 1:37:05am
+    Author:  max
+
+  ==============================================================================
+*/
+
+#include "CutoffTable.h"
+
+void CutoffTable::prepare(double sampleRate)
+{
+    currentSampleRate = sampleRate;
+
+    ladderCoefficients.resize(static_cast<size_t>(numPoints));
+
+    for (int point = 0; point < numPoints; ++point)
+    {
+        const double cycles = point * spacing / sampleRate;
+        ladderCoefficients[static_cast<size_t>(point)] = static_cast<float>(std::exp(-juce::MathConstants<double>::twoPi * cycles));
+    }
+}
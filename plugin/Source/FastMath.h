@@ -0,0 +1,241 @@
+/*
+  ==============================================================================
+
+    FastMath.h
+    Created: 17 Oct 2026 9:26:44pm
+    Author:  max
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <cstring>
+
+// Approximations of the transcendental functions used on the audio thread, each at three
+// accuracy tiers. The polynomials are minimax fits (Lawson iteration over Chebyshev nodes).
+// Everything is branch-free float code, so loops over buffers vectorise; there are also
+// SIMDRegister versions for the voice bank kernels.
+//
+// As printed by the MaxSynthFastMathBenchmark target (Benchmarks/FastMathBenchmark.cpp), on an
+// x86-64 Xeon VM with SSE2 code from g++ 12 -O3 -fno-trapping-math: the max absolute error against
+// double precision over 10^7 points (relative for exp2), and ns per value over a 64k buffer, next
+// to the float std:: functions. The timings moved by up to a third between runs on that machine.
+//
+//   function          error: low     medium   high     libm       ns: low  medium  high   libm
+//   sin, |x| <= pi           2.5e-4  6.3e-6   6.9e-7   3.3e-8         0.9  1.1     1.3    5.8
+//   cos, |x| <= 20           2.5e-4  7.7e-6   2.2e-6   3.3e-8         1.2  1.3     1.5    6.8
+//   tanh, |x| <= 10          2.4e-2  1.4e-6   2.0e-7   1.0e-7         1.0  2.6     2.8    23.7
+//   exp2, |x| <= 100         7.5e-5  2.7e-6   1.7e-7   6.0e-8         1.3  1.4     1.5    4.6
+//   log2, 1e-9..1e9          1.0e-4  3.1e-6   1.0e-6   9.6e-7         1.0  1.4     1.6    3.9
+//
+// The sin/cos error grows with |x|, as the float argument itself runs out of fractional bits, and
+// log2's high tier is as close as a float result of up to 30 can get.
+// Without -fno-trapping-math the compiler keeps the clamps as branches and tanh, exp2 and
+// log2 loops stay scalar.
+//
+// sin and cos take radians; sin2pi takes the phase in cycles, already within -0.5..0.5.
+namespace FastMath
+{
+    using SIMDFloat = juce::dsp::SIMDRegister<float>;
+
+    enum class Accuracy { low, medium, high };
+
+    namespace detail
+    {
+        // Unrolled at compile time: a loop here would keep the callers' loops from vectorising
+        template <size_t I = 0, size_t N>
+        inline float horner(const float x, const float (&c)[N]) noexcept
+        {
+            if constexpr (I == N - 1)
+                return c[I];
+            else
+                return horner<I + 1>(x, c) * x + c[I];
+        }
+
+        template <size_t I = 0, size_t N>
+        inline SIMDFloat horner(const SIMDFloat x, const float (&c)[N]) noexcept
+        {
+            if constexpr (I == N - 1)
+                return SIMDFloat::expand(c[I]);
+            else
+                return SIMDFloat::multiplyAdd(SIMDFloat::expand(c[I]), horner<I + 1>(x, c), x);
+        }
+
+        // sin(2 pi t) / t as a polynomial in t^2, for |t| <= 0.5
+        constexpr float sinLow[] = { 6.2786354627f, -41.093730767f, 77.930349460f, -56.086392559f };
+        constexpr float sinMedium[] = { 6.2830557986f, -41.331214296f, 81.366815043f, -74.478002738f, 32.781396789f };
+        constexpr float sinHigh[] = { 6.2831828186f, -41.341421399f, 81.596183869f, -76.580100451f, 41.205394430f, -12.271261534f };
+
+        // 2^f for 0 <= f < 1
+        constexpr float exp2Low[] = { 0.99992522008f, 0.69583353072f, 0.22606716716f, 0.078024521485f };
+        constexpr float exp2Medium[] = { 1.0000025933f, 0.69300383525f, 0.24144275477f, 0.052011462260f, 0.013534167783f };
+        constexpr float exp2High[] = { 0.99999992507f, 0.69315307316f, 0.24015361724f, 0.055826317720f, 0.0089893402818f, 0.0018775766625f };
+
+        // log2(1 + u) / u for sqrt(0.5) - 1 <= u < sqrt(2) - 1
+        constexpr float log2Low[] = { 1.4417606427f, -0.72490416852f, 0.51750950566f, -0.32962980450f };
+        constexpr float log2Medium[] = { 1.4427134815f, -0.72113185752f, 0.47934801130f, -0.36748999031f, 0.32215488389f, -0.20659179307f };
+        constexpr float log2High[] = { 1.4426947724f, -0.72135714897f, 0.48093944503f, -0.36008721381f, 0.28670744915f, -0.25006905970f, 0.23689043240f, -0.14574448407f };
+
+        template <Accuracy accuracy, typename T>
+        inline T sinPolynomial(const T t) noexcept
+        {
+            if constexpr (accuracy == Accuracy::low)
+                return horner(t * t, sinLow) * t;
+            else if constexpr (accuracy == Accuracy::medium)
+                return horner(t * t, sinMedium) * t;
+            else
+                return horner(t * t, sinHigh) * t;
+        }
+
+        // Done in integers, the compiler won't if-convert a float compare and select
+        inline int floorToInt(const float x) noexcept
+        {
+            const int t = static_cast<int>(x);
+            return t - static_cast<int>(x < static_cast<float>(t));
+        }
+
+        inline float floorToFloat(const float x) noexcept { return static_cast<float>(floorToInt(x)); }
+
+        inline SIMDFloat floorToFloat(const SIMDFloat x) noexcept
+        {
+            const auto t = SIMDFloat::truncate(x);
+            return t - (SIMDFloat::expand(1.0f) & SIMDFloat::greaterThan(t, x));
+        }
+
+        // Runs a scalar function on every lane of a register. The fixed-length loop over an aligned
+        // array is vectorised by the compiler, which SIMDRegister can't do for division or bit casts.
+        template <typename Function>
+        inline SIMDFloat perLane(const SIMDFloat x, Function&& function) noexcept
+        {
+            alignas(64) float lanes[SIMDFloat::size()];
+            x.copyToRawArray(lanes);
+
+            for (auto& lane : lanes)
+                lane = function(lane);
+
+            return SIMDFloat::fromRawArray(lanes);
+        }
+    }
+
+    // sin(2 pi t) for -0.5 <= t <= 0.5
+    template <Accuracy accuracy = Accuracy::high>
+    inline float sin2pi(const float t) noexcept { return detail::sinPolynomial<accuracy>(t); }
+
+    template <Accuracy accuracy = Accuracy::high>
+    inline SIMDFloat sin2pi(const SIMDFloat t) noexcept { return detail::sinPolynomial<accuracy>(t); }
+
+    template <Accuracy accuracy = Accuracy::high>
+    inline float sin(const float x) noexcept
+    {
+        auto t = x * (1.0f / juce::MathConstants<float>::twoPi);
+        t -= detail::floorToFloat(t + 0.5f);
+        return sin2pi<accuracy>(t);
+    }
+
+    template <Accuracy accuracy = Accuracy::high>
+    inline SIMDFloat sin(const SIMDFloat x) noexcept
+    {
+        auto t = x * (1.0f / juce::MathConstants<float>::twoPi);
+        t -= detail::floorToFloat(t + SIMDFloat::expand(0.5f));
+        return sin2pi<accuracy>(t);
+    }
+
+    template <Accuracy accuracy = Accuracy::high>
+    inline float cos(const float x) noexcept
+    {
+        auto t = x * (1.0f / juce::MathConstants<float>::twoPi) + 0.25f;
+        t -= detail::floorToFloat(t + 0.5f);
+        return sin2pi<accuracy>(t);
+    }
+
+    template <Accuracy accuracy = Accuracy::high>
+    inline SIMDFloat cos(const SIMDFloat x) noexcept
+    {
+        auto t = x * (1.0f / juce::MathConstants<float>::twoPi) + SIMDFloat::expand(0.25f);
+        t -= detail::floorToFloat(t + SIMDFloat::expand(0.5f));
+        return sin2pi<accuracy>(t);
+    }
+
+    // 2^x, clamped to the range of normal floats
+    template <Accuracy accuracy = Accuracy::high>
+    inline float exp2(const float x) noexcept
+    {
+        const float clamped = juce::jlimit(-126.0f, 126.0f, x);
+        // Floor by truncating a positive number (this also keeps the loop free of compares the
+        // compiler won't if-convert). Rounding can make f a hair below 0, which the fit tolerates.
+        const int whole = static_cast<int>(clamped + 128.0f) - 128;
+        const float f = clamped - static_cast<float>(whole);
+
+        float p;
+
+        if constexpr (accuracy == Accuracy::low)
+            p = detail::horner(f, detail::exp2Low);
+        else if constexpr (accuracy == Accuracy::medium)
+            p = detail::horner(f, detail::exp2Medium);
+        else
+            p = detail::horner(f, detail::exp2High);
+
+        // 2^whole, built straight into the exponent bits
+        const auto bits = static_cast<juce::uint32>(whole + 127) << 23;
+        float scale;
+        std::memcpy(&scale, &bits, sizeof(scale));
+        return p * scale;
+    }
+
+    // log2(x) for normal x > 0
+    template <Accuracy accuracy = Accuracy::high>
+    inline float log2(const float x) noexcept
+    {
+        juce::uint32 bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+
+        // x = m * 2^e with m in 1..2, then moved to sqrt(0.5)..sqrt(2) so the polynomial is centred on 1
+        auto e = static_cast<float>(static_cast<int>(bits >> 23) - 127);
+        bits = (bits & 0x007fffffu) | 0x3f800000u;
+        float m;
+        std::memcpy(&m, &bits, sizeof(m));
+
+        const bool upper = m > juce::MathConstants<float>::sqrt2;
+        m = upper ? m * 0.5f : m;
+        e = upper ? e + 1.0f : e;
+
+        const float u = m - 1.0f;
+
+        if constexpr (accuracy == Accuracy::low)
+            return e + u * detail::horner(u, detail::log2Low);
+        else if constexpr (accuracy == Accuracy::medium)
+            return e + u * detail::horner(u, detail::log2Medium);
+        else
+            return e + u * detail::horner(u, detail::log2High);
+    }
+
+    // Low is the (3,2) Pade approximant, clamped where it reaches 1: it stays monotonic with a
+    // smooth knee, which is all saturation needs. The others go through exp2 of the same tier.
+    template <Accuracy accuracy = Accuracy::high>
+    inline float tanh(const float x) noexcept
+    {
+        if constexpr (accuracy == Accuracy::low)
+        {
+            const float c = juce::jlimit(-3.0f, 3.0f, x);
+            const float c2 = c * c;
+            return c * (27.0f + c2) / (27.0f + 9.0f * c2);
+        }
+        else
+        {
+            // 1 - 2 / (e^2x + 1) with e^2x = 2^(2x / ln 2), beyond |x| = 9 it's 1 to float precision
+            const float c = juce::jlimit(-9.0f, 9.0f, x);
+            return 1.0f - 2.0f / (exp2<accuracy>(c * 2.8853900818f) + 1.0f);
+        }
+    }
+
+    template <Accuracy accuracy = Accuracy::high>
+    inline SIMDFloat tanh(const SIMDFloat x) noexcept { return detail::perLane(x, [] (const float v) { return tanh<accuracy>(v); }); }
+
+    template <Accuracy accuracy = Accuracy::high>
+    inline SIMDFloat exp2(const SIMDFloat x) noexcept { return detail::perLane(x, [] (const float v) { return exp2<accuracy>(v); }); }
+
+    template <Accuracy accuracy = Accuracy::high>
+    inline SIMDFloat log2(const SIMDFloat x) noexcept { return detail::perLane(x, [] (const float v) { return log2<accuracy>(v); }); }
+}
@@ -0,0 +1,397 @@
+/*
+  ==============================================================================
+
+    LadderFilterBank.cpp
+    Created: 17 Oct 2026 11:58:12pm
+    Author:  max
+
+  ==============================================================================
+*/
+
+#include "LadderFilterBank.h"
+#include "FastMath.h"
+
+namespace
+{
+    using SIMDFloat = LadderFilterBank::SIMDFloat;
+
+    // LadderFilter's defaults: a drive of 1.2 and the gains that go with it
+    constexpr float drive = 1.2f;
+    constexpr float drive2 = drive * 0.04f + 0.96f;
+    const float gain = std::pow(drive, -2.642f) * 0.6103f + 0.3903f;
+    const float gain2 = std::pow(drive2, -2.642f) * 0.6103f + 0.3903f;
+
+    constexpr float outputGain = 1.2f;
+    constexpr float minResonance = 0.1f; // What a resonance of 0 scales to, LadderFilter's floor
+    constexpr double smoothingSeconds = 0.05;
+
+    // Stage weights and input compensation of each mode, as in LadderFilter::setMode
+    struct ModeSettings
+    {
+        float weights[5];
+        float compensation;
+    };
+
+    constexpr ModeSettings modeSettings[] = {
+        { { 0.0f, 0.0f, 1.0f, 0.0f, 0.0f }, 0.5f },    // LPF12
+        { { 0.0f, 0.0f, 0.0f, 0.0f, 1.0f }, 0.5f },    // LPF24
+        { { 1.0f, -2.0f, 1.0f, 0.0f, 0.0f }, 0.0f },   // HPF12
+        { { 1.0f, -4.0f, 6.0f, -4.0f, 1.0f }, 0.0f },  // HPF24
+        { { 0.0f, 0.0f, -1.0f, 1.0f, 0.0f }, 0.5f },   // BPF12
+        { { 0.0f, 0.0f, 1.0f, -2.0f, 1.0f }, 0.5f }    // BPF24
+    };
+
+    // Stands in for LadderFilter's tanh lookup table, and is closer to tanh than the table
+    template <typename T>
+    inline T saturate(const T x) noexcept
+    {
+        return FastMath::tanh<FastMath::Accuracy::high>(x);
+    }
+}
+
+void LadderFilterBank::Ramp::setTarget(const int lane, const float value, const int length) noexcept
+{
+    if (value == target[lane])
+        return;
+
+    target[lane] = value;
+    remaining[lane] = static_cast<float>(length);
+    step[lane] = (value - current[lane]) / static_cast<float>(length);
+}
+
+void LadderFilterBank::Ramp::jumpToTarget(const int lane) noexcept
+{
+    current[lane] = target[lane];
+    remaining[lane] = 0.0f;
+}
+
+LadderFilterBank::RampLanes::RampLanes(const Ramp& ramp, const int firstLane) noexcept
+    : current(SIMDFloat::fromRawArray(ramp.current + firstLane)),
+      target(SIMDFloat::fromRawArray(ramp.target + firstLane)),
+      step(SIMDFloat::fromRawArray(ramp.step + firstLane)),
+      remaining(SIMDFloat::fromRawArray(ramp.remaining + firstLane))
+{
+}
+
+void LadderFilterBank::RampLanes::store(Ramp& ramp, const int firstLane) const noexcept
+{
+    current.copyToRawArray(ramp.current + firstLane);
+    remaining.copyToRawArray(ramp.remaining + firstLane);
+}
+
+SIMDFloat LadderFilterBank::RampLanes::next() noexcept
+{
+    // Lanes still ramping take a step, and land exactly on the target with their last one
+    const auto ramping = SIMDFloat::greaterThan(remaining, SIMDFloat::expand(0.0f));
+    remaining = remaining - (SIMDFloat::expand(1.0f) & ramping);
+    const auto arrived = SIMDFloat::lessThanOrEqual(remaining, SIMDFloat::expand(0.0f));
+
+    const auto stepped = current + (step & ramping);
+    current = (target & arrived) + (stepped & ~arrived);
+    return current;
+}
+
+void LadderFilterBank::prepare(const CutoffTable& table, int maxBlockSize, int lanes)
+{
+    cutoffTable = &table;
+    numLanes = ((lanes + laneWidth - 1) / laneWidth) * laneWidth;
+    numIntervals = (maxBlockSize + controlInterval - 1) / controlInterval;
+    rampLength = static_cast<int>(std::floor(smoothingSeconds * table.getSampleRate()));
+
+    // Same single aligned allocation as the voice bank: every array is a whole number of registers
+    const int numRows = 2 * numStages + numStages + 1 + numIntervals + 8;
+    stateMemory.calloc(static_cast<size_t>(numRows * numLanes) * sizeof(float) + stateAlignment);
+    auto* data = juce::snapPointerToAlignment(reinterpret_cast<float*>(stateMemory.getData()), stateAlignment);
+
+    auto takeRows = [&data, this] (const int rows)
+    {
+        auto* rowData = data;
+        data += rows * numLanes;
+        return rowData;
+    };
+
+    for (auto& channel : states)
+        for (auto& stage : channel)
+            stage = takeRows(1);
+
+    for (auto& weights : outputWeights)
+        weights = takeRows(1);
+
+    compensation = takeRows(1);
+    cutoffSchedule = takeRows(numIntervals);
+
+    for (auto* ramp : { &cutoffTransform, &scaledResonance })
+    {
+        ramp->current = takeRows(1);
+        ramp->target = takeRows(1);
+        ramp->step = takeRows(1);
+        ramp->remaining = takeRows(1);
+    }
+
+    // Every lane starts like a fresh LadderFilter: LPF12, no resonance, 1 kHz
+    modes.assign(static_cast<size_t>(numLanes), Mode::lpf24);
+    oversamplingFactors.assign(static_cast<size_t>(numLanes), 1);
+
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        setMode(lane, Mode::lpf12);
+        setResonance(lane, 0.0f);
+
+        for (int interval = 0; interval < numIntervals; ++interval)
+            cutoffSchedule[interval * numLanes + lane] = 1000.0f;
+
+        cutoffTransform.setTarget(lane, table.getLadderCoefficient(1000.0f), rampLength);
+        reset(lane);
+    }
+}
+
+void LadderFilterBank::reset(const int lane)
+{
+    for (auto& channel : states)
+        for (auto* stage : channel)
+            stage[lane] = 0.0f;
+
+    cutoffTransform.jumpToTarget(lane);
+    scaledResonance.jumpToTarget(lane);
+}
+
+void LadderFilterBank::setMode(const int lane, const Mode newMode)
+{
+    if (modes[static_cast<size_t>(lane)] == newMode)
+        return;
+
+    const auto& settings = modeSettings[static_cast<int>(newMode)];
+
+    for (int stage = 0; stage < numStages; ++stage)
+        outputWeights[stage][lane] = settings.weights[stage] * outputGain;
+
+    compensation[lane] = settings.compensation;
+    modes[static_cast<size_t>(lane)] = newMode;
+    reset(lane);
+}
+
+void LadderFilterBank::setResonance(const int lane, const float resonance)
+{
+    scaledResonance.setTarget(lane, juce::jmap(resonance, minResonance, 1.0f), rampLength * oversamplingFactors[static_cast<size_t>(lane)]);
+}
+
+void LadderFilterBank::setCutoff(const int lane, const int interval, const float cutoffHz)
+{
+    jassert(interval < numIntervals);
+    cutoffSchedule[interval * numLanes + lane] = cutoffHz;
+}
+
+bool LadderFilterBank::isTransparent(const int lane, const int numIntervals, const float minCutoffHz) const noexcept
+{
+    jassert(numIntervals <= this->numIntervals);
+
+    if (modes[static_cast<size_t>(lane)] != Mode::lpf12 || scaledResonance.target[lane] > minResonance || scaledResonance.remaining[lane] > 0.0f)
+        return false;
+
+    // A smaller coefficient is a higher cutoff, and the one the lane is at has to be past it too
+    const int factor = oversamplingFactors[static_cast<size_t>(lane)];
+
+    if (cutoffTransform.current[lane] > cutoffTable->getLadderCoefficient(minCutoffHz / static_cast<float>(factor)))
+        return false;
+
+    for (int interval = 0; interval < numIntervals; ++interval)
+        if (cutoffSchedule[interval * numLanes + lane] < minCutoffHz)
+            return false;
+
+    return true;
+}
+
+float LadderFilterBank::getTransparentGain() noexcept
+{
+    // Below the cutoff every stage follows the input stage, so the feedback loop settles at
+    // (1 + 4 r compensation) / (1 + 4 r drive2 gain2) of the driven input
+    const auto& settings = modeSettings[static_cast<int>(Mode::lpf12)];
+    const float feedback = 4.0f * minResonance;
+    return outputGain * drive * gain * (1.0f + feedback * settings.compensation) / (1.0f + feedback * drive2 * gain2);
+}
+
+void LadderFilterBank::setOversampling(const int firstLane, const int factor)
+{
+    const int previous = oversamplingFactors[static_cast<size_t>(firstLane)];
+
+    if (factor == previous)
+        return;
+
+    // The coefficient is exp(-2 pi fc / (factor fs)), so it converts with a power. The ramps keep
+    // their duration: factor times as many steps, each that much smaller.
+    const float exponent = static_cast<float>(previous) / static_cast<float>(factor);
+
+    for (int lane = firstLane; lane < firstLane + laneWidth; ++lane)
+    {
+        cutoffTransform.current[lane] = std::pow(cutoffTransform.current[lane], exponent);
+        cutoffTransform.target[lane] = std::pow(cutoffTransform.target[lane], exponent);
+
+        for (auto* ramp : { &cutoffTransform, &scaledResonance })
+        {
+            ramp->remaining[lane] = std::ceil(ramp->remaining[lane] / exponent);
+            ramp->step[lane] = ramp->remaining[lane] > 0.0f ? (ramp->target[lane] - ramp->current[lane]) / ramp->remaining[lane] : 0.0f;
+        }
+
+        oversamplingFactors[static_cast<size_t>(lane)] = factor;
+    }
+}
+
+LadderFilterBank::LaneGroup::LaneGroup(LadderFilterBank& owner, const int first, const int channels) noexcept
+    : bank(owner), firstLane(first), numChannels(channels),
+      cutoff(owner.cutoffTransform, first), resonance(owner.scaledResonance, first)
+{
+    for (int stage = 0; stage < numStages; ++stage)
+        weights[stage] = SIMDFloat::fromRawArray(bank.outputWeights[stage] + firstLane);
+
+    compensation = SIMDFloat::fromRawArray(bank.compensation + firstLane);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        for (int stage = 0; stage < numStages; ++stage)
+            stages[channel][stage] = SIMDFloat::fromRawArray(bank.states[channel][stage] + firstLane);
+}
+
+void LadderFilterBank::LaneGroup::store() const noexcept
+{
+    for (int channel = 0; channel < numChannels; ++channel)
+        for (int stage = 0; stage < numStages; ++stage)
+            stages[channel][stage].copyToRawArray(bank.states[channel][stage] + firstLane);
+
+    cutoff.store(bank.cutoffTransform, firstLane);
+    resonance.store(bank.scaledResonance, firstLane);
+}
+
+void LadderFilterBank::LaneGroup::nextSample() noexcept
+{
+    a1 = cutoff.next();
+    feedback = resonance.next() * -4.0f;
+
+    const auto g = SIMDFloat::expand(1.0f) - a1;
+    b0 = g * 0.76923076923f;
+    b1 = g * 0.23076923076f;
+}
+
+SIMDFloat LadderFilterBank::LaneGroup::filter(const int channel, const SIMDFloat dx) noexcept
+{
+    auto& st = stages[channel];
+    const auto a = dx + feedback * (saturate(st[4] * drive2) * gain2 - dx * compensation);
+    const auto b = b1 * st[0] + a1 * st[1] + b0 * a;
+    const auto c = b1 * st[1] + a1 * st[2] + b0 * b;
+    const auto d = b1 * st[2] + a1 * st[3] + b0 * c;
+    const auto e = b1 * st[3] + a1 * st[4] + b0 * d;
+
+    st[0] = a;
+    st[1] = b;
+    st[2] = c;
+    st[3] = d;
+    st[4] = e;
+
+    return a * weights[0] + b * weights[1] + c * weights[2] + d * weights[3] + e * weights[4];
+}
+
+void LadderFilterBank::setCutoffTargets(const int firstLane, const int interval)
+{
+    // The interval's cutoffs become the ramp targets, as setCutoffFrequencyHz did before each chunk.
+    // Oversampled, the same cutoff is that many times fewer cycles per sample.
+    const int factor = oversamplingFactors[static_cast<size_t>(firstLane)];
+    const float cutoffScale = 1.0f / static_cast<float>(factor);
+
+    for (int lane = firstLane; lane < firstLane + laneWidth; ++lane)
+        cutoffTransform.setTarget(lane, cutoffTable->getLadderCoefficient(cutoffSchedule[interval * numLanes + lane] * cutoffScale), rampLength * factor);
+}
+
+void LadderFilterBank::driveInputs(float* const* channels, const int numChannels, const int stride, const int numSamples,
+                                   float (&driven)[2][controlInterval * laneWidth]) noexcept
+{
+    // The input saturation doesn't depend on the state, so it is done for the whole chunk
+    // up front in one flat loop, which vectorises far better than a call per sample
+    jassert(numSamples <= controlInterval);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* channelInputs = driven[channel];
+
+        for (int sample = 0; sample < numSamples; ++sample)
+            SIMDFloat::fromRawArray(channels[channel] + sample * stride).copyToRawArray(channelInputs + sample * laneWidth);
+
+        for (int i = 0; i < numSamples * laneWidth; ++i)
+            channelInputs[i] = saturate(channelInputs[i] * drive) * gain;
+    }
+}
+
+void LadderFilterBank::process(const int firstLane, const int interval, float* left, float* right, const int stride, const int numSamples)
+{
+    const int numChannels = right != nullptr ? 2 : 1;
+    float* channels[2] = { left, right };
+
+    alignas(stateAlignment) float drivenInputs[2][controlInterval * laneWidth];
+    driveInputs(channels, numChannels, stride, numSamples, drivenInputs);
+
+    setCutoffTargets(firstLane, interval);
+    LaneGroup lanes(*this, firstLane, numChannels);
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        lanes.nextSample();
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto dx = SIMDFloat::fromRawArray(drivenInputs[channel] + sample * laneWidth);
+            lanes.filter(channel, dx).copyToRawArray(channels[channel] + sample * stride);
+        }
+    }
+
+    lanes.store();
+}
+
+void LadderFilterBank::processPair(const int firstLane, const int secondLane, const int interval, const bool serial,
+                                   float* left, float* right, const int stride, const int numSamples)
+{
+    const int numChannels = right != nullptr ? 2 : 1;
+    float* channels[2] = { left, right };
+
+    alignas(stateAlignment) float drivenInputs[2][controlInterval * laneWidth];
+    driveInputs(channels, numChannels, stride, numSamples, drivenInputs);
+
+    setCutoffTargets(firstLane, interval);
+    setCutoffTargets(secondLane, interval);
+    LaneGroup first(*this, firstLane, numChannels);
+    LaneGroup second(*this, secondLane, numChannels);
+
+    if (serial)
+    {
+        // One pass: each sample of the first filter's output is driven and goes straight on into
+        // the second, both filters' state staying in registers for the whole chunk
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            first.nextSample();
+            second.nextSample();
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                const auto dx = SIMDFloat::fromRawArray(drivenInputs[channel] + sample * laneWidth);
+                const auto secondInput = saturate(first.filter(channel, dx) * drive) * gain;
+                second.filter(channel, secondInput).copyToRawArray(channels[channel] + sample * stride);
+            }
+        }
+    }
+    else
+    {
+        // In parallel both filters take the same driven input, and their two independent
+        // chains advance side by side in one loop
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            first.nextSample();
+            second.nextSample();
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                const auto dx = SIMDFloat::fromRawArray(drivenInputs[channel] + sample * laneWidth);
+                const auto output = (first.filter(channel, dx) + second.filter(channel, dx)) * 0.5f;
+                output.copyToRawArray(channels[channel] + sample * stride);
+            }
+        }
+    }
+
+    first.store();
+    second.store();
+}
@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+    LadderFilterBank.h
+    Created: 17 Oct 2026 11:58:12pm
+    Author:  max
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "CutoffTable.h"
+
+// The ladder filters of all voices, with one voice per SIMD lane, so a whole register of
+// voices is filtered in one pass over the voice bank's interleaved output. It is the same
+// filter as juce::dsp::LadderFilter (same modes, drive, resonance and compensation, and the
+// same 50 ms linear smoothing of cutoff and resonance), with every lane keeping its own
+// cutoff, resonance and mode. The saturation uses FastMath::tanh instead of JUCE's 128 point
+// lookup table.
+//
+// Cutoffs are scheduled per control interval: the voices write a target for each stretch of
+// controlInterval samples of the coming block before it is rendered.
+//
+// Two registers of lanes can also be filtered as one voice's pair of filters, in series or in
+// parallel, loaded once for the chunk and run side by side in one loop. In parallel they also
+// share the input drive.
+class LadderFilterBank
+{
+public:
+    using SIMDFloat = juce::dsp::SIMDRegister<float>;
+    static constexpr int laneWidth = static_cast<int>(SIMDFloat::size());
+    static constexpr int controlInterval = 32; // Samples per cutoff target
+
+    // In the order of the filterMode parameter choices
+    enum class Mode { lpf12, lpf24, hpf12, hpf24, bpf12, bpf24 };
+
+    LadderFilterBank() = default;
+    // The cutoff coefficients come from table, which has to outlive the bank
+    void prepare(const CutoffTable& table, int maxBlockSize, int numLanes);
+
+    // Clears a lane's state and moves its smoothed cutoff and resonance straight to their targets
+    void reset(const int lane);
+
+    // Changing the mode resets the lane, like LadderFilter::setMode
+    void setMode(const int lane, const Mode newMode);
+    void setResonance(const int lane, const float resonance);
+
+    // Cutoff target for the samples interval * controlInterval onwards of the coming block
+    void setCutoff(const int lane, const int interval, const float cutoffHz);
+
+    // True if a lane would hardly change the first numIntervals intervals of the coming block: a 12 dB
+    // low pass with no resonance (and none on its way) and the cutoff at minCutoffHz or above all along.
+    // A voice bank can then stand in for it with getTransparentGain.
+    bool isTransparent(const int lane, const int numIntervals, const float minCutoffHz) const noexcept;
+
+    // Small-signal level of a low pass lane with no resonance, what is left of the drive and output gain
+    static float getTransparentGain() noexcept;
+
+    // Rate the lanes firstLane..firstLane + laneWidth - 1 run at, as a multiple of the sample rate.
+    // The smoothed cutoff and resonance carry over, so it can change while they play.
+    void setOversampling(const int firstLane, const int factor);
+
+    // Filters one control interval of the lanes firstLane..firstLane + laneWidth - 1 in place, or a
+    // part of one: numSamples are at the lanes' rate. Channel c of sample s is at channels[c][s * stride];
+    // right is null for a mono block.
+    void process(const int firstLane, const int interval, float* left, float* right, const int stride, const int numSamples);
+
+    // Like process, but for the lanes firstLane.. and secondLane.. together as two filters of the
+    // same voices: in series, the first one's output driving the second, or in parallel on the same
+    // input with their outputs averaged
+    void processPair(const int firstLane, const int secondLane, const int interval, const bool serial,
+                     float* left, float* right, const int stride, const int numSamples);
+
+private:
+    static constexpr int numStages = 5;
+    static constexpr size_t stateAlignment = 64;
+
+    // A linear ramp per lane, stepped like juce::SmoothedValue
+    struct Ramp
+    {
+        float* current = nullptr;
+        float* target = nullptr;
+        float* step = nullptr;
+        float* remaining = nullptr; // Samples left to the target, as a float so it can be counted down in a register
+
+        void setTarget(const int lane, const float value, const int rampLength) noexcept;
+        void jumpToTarget(const int lane) noexcept;
+    };
+
+    // A register's worth of a Ramp, kept out of memory while a chunk is filtered
+    struct RampLanes
+    {
+        RampLanes(const Ramp& ramp, const int firstLane) noexcept;
+        void store(Ramp& ramp, const int firstLane) const noexcept;
+        SIMDFloat next() noexcept;
+
+        SIMDFloat current, target, step, remaining;
+    };
+
+    // A register of lanes while they filter a chunk: their settings, ramps and stages in registers
+    struct LaneGroup
+    {
+        LaneGroup(LadderFilterBank& bank, const int firstLane, const int numChannels) noexcept;
+        void store() const noexcept;
+
+        // Steps the smoothed cutoff and resonance, once per sample for both channels
+        void nextSample() noexcept;
+
+        // One sample of a channel through the ladder, from an already driven input
+        SIMDFloat filter(const int channel, const SIMDFloat drivenInput) noexcept;
+
+        LadderFilterBank& bank;
+        const int firstLane, numChannels;
+        SIMDFloat weights[numStages], compensation;
+        RampLanes cutoff, resonance;
+        SIMDFloat a1, b0, b1, feedback;
+        SIMDFloat stages[2][numStages];
+    };
+
+    // Makes the interval's scheduled cutoffs the lanes' ramp targets
+    void setCutoffTargets(const int firstLane, const int interval);
+
+    // Copies the chunk's inputs (rows of stride) into driven (rows of laneWidth), saturated
+    static void driveInputs(float* const* channels, const int numChannels, const int stride, const int numSamples,
+                            float (&driven)[2][controlInterval * laneWidth]) noexcept;
+
+    const CutoffTable* cutoffTable = nullptr;
+    int numLanes = 0;
+    int numIntervals = 0;
+    int rampLength = 0; // Samples the smoothing takes at the sample rate
+
+    juce::HeapBlock<char> stateMemory;
+    float* states[2][numStages] = {}; // Per channel and stage, numLanes long
+    float* outputWeights[numStages] = {}; // Mix of the stages that makes the mode, per lane
+    float* compensation = nullptr; // Share of the input fed back against the resonance, per lane
+    float* cutoffSchedule = nullptr; // cutoffSchedule[interval * numLanes + lane], in Hz
+    Ramp cutoffTransform; // exp(-2 pi cutoff / sampleRate), the ladder's one-pole coefficient
+    Ramp scaledResonance;
+    std::vector<Mode> modes;
+    std::vector<int> oversamplingFactors; // Per lane, see setOversampling
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LadderFilterBank)
+};
@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+    MasterBus.cpp
+    Created: 17 Oct 2026 2:31:07pm
+    Author:  max
+
+  ==============================================================================
+*/
+
+#include "MasterBus.h"
+
+namespace
+{
+    using SIMDFloat = MasterBus::SIMDFloat;
+
+    // Everything below the threshold passes untouched, above it a cubic knee bends the
+    // signal over to exactly +-1 (the knee is (4/27) e^3 away from linear and flat at e = 1.5).
+    // Same shape as the old per-voice tanh limiter up to a few percent, but without a tanh.
+    constexpr float limiterThreshold = 0.95f;
+    constexpr float limiterKneeWidth = 0.05f;
+    constexpr float limiterKneeEnd = 1.5f;
+    constexpr float limiterKneeCurve = 4.0f / 27.0f;
+
+    inline float limitSample(const float x) noexcept
+    {
+        const float magnitude = std::abs(x);
+        const float e = juce::jmin((juce::jmax(magnitude - limiterThreshold, 0.0f)) / limiterKneeWidth, limiterKneeEnd);
+        const float limited = juce::jmin(magnitude, limiterThreshold) + limiterKneeWidth * (e - limiterKneeCurve * e * e * e);
+        return x < 0.0f ? -limited : limited;
+    }
+
+    inline SIMDFloat limitSamples(const SIMDFloat x) noexcept
+    {
+        const auto magnitude = SIMDFloat::abs(x);
+        auto e = SIMDFloat::max(magnitude - SIMDFloat::expand(limiterThreshold), SIMDFloat::expand(0.0f)) * (1.0f / limiterKneeWidth);
+        e = SIMDFloat::min(e, SIMDFloat::expand(limiterKneeEnd));
+
+        const auto knee = e - e * e * e * limiterKneeCurve;
+        const auto limited = SIMDFloat::multiplyAdd(SIMDFloat::min(magnitude, SIMDFloat::expand(limiterThreshold)), knee, SIMDFloat::expand(limiterKneeWidth));
+
+        const auto negative = SIMDFloat::lessThan(x, SIMDFloat::expand(0.0f));
+        return ((SIMDFloat::expand(0.0f) - limited) & negative) + (limited & ~negative);
+    }
+}
+
+MasterBus::MasterBus()
+{
+}
+
+void MasterBus::prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels)
+{
+    masterGain.reset(sampleRate, 0.02);
+    gainRamp.assign(static_cast<size_t>(samplesPerBlock), 0.0f);
+
+    // ~10 Hz corner, well below anything the synth is meant to play
+    dcCoefficient = static_cast<float>(1.0 - juce::MathConstants<double>::twoPi * 10.0 / sampleRate);
+    dcLastInput.assign(static_cast<size_t>(numChannels), 0.0f);
+    dcLastOutput.assign(static_cast<size_t>(numChannels), 0.0f);
+}
+
+void MasterBus::setMasterGain(const float newGain)
+{
+    masterGain.setTargetValue(newGain);
+}
+
+void MasterBus::process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    applyGain(buffer, startSample, numSamples);
+
+    for (int channel = 0; channel < juce::jmin(buffer.getNumChannels(), static_cast<int>(dcLastInput.size())); ++channel)
+    {
+        auto* data = buffer.getWritePointer(channel, startSample);
+        blockDC(data, channel, numSamples);
+        limit(data, numSamples);
+    }
+}
+
+bool MasterBus::isSilent() const noexcept
+{
+    // -100 dB. The blocker's next output starts from -x[n-1], so a held input would still come
+    // out as a step once the voices stop, and a moving gain has to finish before it can be skipped.
+    const auto isQuiet = [](float value) { return std::abs(value) < 1.0e-5f; };
+
+    return !masterGain.isSmoothing()
+        && std::all_of(dcLastInput.begin(), dcLastInput.end(), isQuiet)
+        && std::all_of(dcLastOutput.begin(), dcLastOutput.end(), isQuiet);
+}
+
+void MasterBus::applyGain(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    if (!masterGain.isSmoothing())
+    {
+        buffer.applyGain(startSample, numSamples, masterGain.getTargetValue());
+        return;
+    }
+
+    // Work through the ramp in pieces that fit into the preallocated gain buffer
+    for (int offset = 0; offset < numSamples; offset += static_cast<int>(gainRamp.size()))
+    {
+        const int chunkSize = juce::jmin(static_cast<int>(gainRamp.size()), numSamples - offset);
+
+        for (int i = 0; i < chunkSize; ++i)
+            gainRamp[static_cast<size_t>(i)] = masterGain.getNextValue();
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            juce::FloatVectorOperations::multiply(buffer.getWritePointer(channel, startSample + offset), gainRamp.data(), chunkSize);
+    }
+}
+
+void MasterBus::blockDC(float* data, const int channel, const int numSamples)
+{
+    // A recursive filter, so this one stays a plain loop over time
+    float lastInput = dcLastInput[static_cast<size_t>(channel)];
+    float lastOutput = dcLastOutput[static_cast<size_t>(channel)];
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float input = data[i];
+        lastOutput = input - lastInput + dcCoefficient * lastOutput;
+        lastInput = input;
+        data[i] = lastOutput;
+    }
+
+    dcLastInput[static_cast<size_t>(channel)] = lastInput;
+    dcLastOutput[static_cast<size_t>(channel)] = lastOutput;
+}
+
+void MasterBus::limit(float* data, const int numSamples)
+{
+    // Scalar up to the first aligned sample, then whole registers, then the scalar tail
+    auto* alignedStart = juce::jmin(data + numSamples, SIMDFloat::getNextSIMDAlignedPtr(data));
+    const int head = static_cast<int>(alignedStart - data);
+    const int numVectors = (numSamples - head) / static_cast<int>(SIMDFloat::size());
+    const int tail = head + numVectors * static_cast<int>(SIMDFloat::size());
+
+    for (int i = 0; i < head; ++i)
+        data[i] = limitSample(data[i]);
+
+    for (int i = head; i < tail; i += static_cast<int>(SIMDFloat::size()))
+        limitSamples(SIMDFloat::fromRawArray(data + i)).copyToRawArray(data + i);
+
+    for (int i = tail; i < numSamples; ++i)
+        data[i] = limitSample(data[i]);
+}
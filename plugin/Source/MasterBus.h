@@ -0,0 +1,45 @@
+/*
+  ==============================================================================
+
+    MasterBus.h
+    Created: 17 Oct 2026 2:31:07pm
+    Author:  max
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Runs once over the final voice mix: smoothed master gain, a DC blocker and a soft
+// limiter, so the voices themselves only have to add their samples into the output.
+class MasterBus
+{
+public:
+    using SIMDFloat = juce::dsp::SIMDRegister<float>;
+
+    MasterBus();
+    void prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels);
+    void setMasterGain(const float newGain);
+    void process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    // True once the DC blocker has no tail left in either state and the gain has settled,
+    // so skipping the bus can't cut anything off
+    bool isSilent() const noexcept;
+
+private:
+    void applyGain(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+    void blockDC(float* data, const int channel, const int numSamples);
+    static void limit(float* data, const int numSamples);
+
+    juce::SmoothedValue<float> masterGain;
+    std::vector<float> gainRamp; // Per-sample gain while masterGain is moving
+
+    // One-pole DC blocker, y[n] = x[n] - x[n-1] + r * y[n-1]
+    float dcCoefficient = 0.9986f;
+    std::vector<float> dcLastInput;
+    std::vector<float> dcLastOutput;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MasterBus)
+};
@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    MaxSynthesiser.cpp
+    Created: 17 Oct 2026 10:40:02am
+    Author:  max
+
+  ==============================================================================
+*/
+
+#include "MaxSynthesiser.h"
+#include "SynthVoice.h"
+
+MaxSynthesiser::MaxSynthesiser()
+{
+}
+
+void MaxSynthesiser::prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels)
+{
+    setCurrentPlaybackSampleRate(sampleRate);
+
+    maxBlockSize = samplesPerBlock;
+
+    // Each voice needs a bit in the voice bank's 64-bit active mask, any voices past that are dropped
+    jassert(getNumVoices() <= VoiceBank::maxVoices);
+
+    while (getNumVoices() > VoiceBank::maxVoices)
+        removeVoice(getNumVoices() - 1);
+
+    voiceBank.prepareToPlay(sampleRate, samplesPerBlock, getNumVoices());
+
+    synthVoices.clear();
+
+    // Every voice gets its own lane in the voice bank (and its own bit in the active mask)
+    for (int i = 0; i < getNumVoices(); ++i)
+    {
+        auto* voice = dynamic_cast<SynthVoice*>(getVoice(i));
+        jassert(voice != nullptr); // MaxSynthesiser only works with SynthVoices
+
+        voice->setVoiceBank(&voiceBank, i);
+        voice->prepareToPlay(sampleRate, samplesPerBlock, numChannels);
+        synthVoices.push_back(voice);
+    }
+
+    activeVoices.reserve(synthVoices.size());
+    activeGroups.reserve(static_cast<size_t>(voiceBank.getNumGroups()));
+}
+
+void MaxSynthesiser::setRenderThreads(const int numWorkerThreads, const int minVoicesPerTask)
+{
+    // Not under the synthesiser's lock, the audio thread would have to wait for the threads to
+    // start and stop. The pool guards itself, renderVoices just renders serially meanwhile.
+    threadPool.setMinItemsPerTask(minVoicesPerTask);
+
+    if (threadPool.getNumWorkers() != numWorkerThreads)
+        threadPool.setNumWorkers(numWorkerThreads);
+}
+
+void MaxSynthesiser::renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples)
+{
+    jassert(maxBlockSize > 0); // prepareToPlay hasn't been called!
+
+    // The voice bank only has room for maxBlockSize samples, so render longer blocks in pieces
+    for (int offset = 0; offset < numSamples; offset += maxBlockSize)
+    {
+        const int chunkSize = juce::jmin(maxBlockSize, numSamples - offset);
+
+        // Only visit the voices that are sounding, lowest index first
+        activeVoices.clear();
+
+        for (auto mask = voiceBank.getActiveVoiceMask(); mask != 0; mask &= mask - 1)
+            activeVoices.push_back(synthVoices[static_cast<size_t>(juce::countNumberOfBitsSet(mask ^ (mask - 1)) - 1)]);
+
+        // The voices' cutoffs for the block first, the bank's filters read them
+        for (auto* voice : activeVoices)
+            voice->updateFilterCutoffs(startSample + offset, chunkSize);
+
+        // Oscillators and filters a register of voices at a time, one register per task: a register
+        // is a whole SIMD group of voices, plenty of work to be worth handing to another thread
+        voiceBank.beginBlock(startSample + offset, chunkSize);
+
+        activeGroups.clear();
+
+        for (int group = 0; group < voiceBank.getNumGroups(); ++group)
+            if (voiceBank.isGroupActive(group))
+                activeGroups.push_back(group);
+
+        auto renderGroup = [this](int index)
+        {
+            voiceBank.renderGroup(activeGroups[static_cast<size_t>(index)]);
+        };
+
+        threadPool.forEach(static_cast<int>(activeGroups.size()), 1, renderGroup);
+
+        // Envelope etc. of the sounding voices, spread over the worker threads
+        // (the pool runs everything right here if it has no workers or too few voices)
+        auto renderVoice = [this, chunkStart = startSample + offset, chunkSize](int index)
+        {
+            activeVoices[static_cast<size_t>(index)]->renderVoice(chunkStart, chunkSize);
+        };
+
+        threadPool.forEach(static_cast<int>(activeVoices.size()), renderVoice);
+
+        // Sum in voice order on this thread, so the result doesn't depend on which thread rendered what
+        for (auto* voice : activeVoices)
+            voice->mixInto(outputAudio, startSample + offset, chunkSize);
+    }
+}
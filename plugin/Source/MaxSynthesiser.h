@@ -0,0 +1,52 @@
+/*
+  ==============================================================================
+
+    MaxSynthesiser.h
+    Created: 17 Oct 2026 10:40:02am
+    Author:  max
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "VoiceBank.h"
+#include "VoiceThreadPool.h"
+
+class SynthVoice;
+
+// juce::Synthesiser that renders the oscillators and filters of all voices together in the
+// VoiceBank before letting each voice run its envelope and panning. With worker threads, both
+// the registers of voices in the bank and the voices after it are spread over them.
+class MaxSynthesiser : public juce::Synthesiser
+{
+public:
+    MaxSynthesiser();
+    void prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels);
+    VoiceBank& getVoiceBank() noexcept { return voiceBank; }
+
+    // Opt-in multithreaded rendering: 0 worker threads renders everything on the audio thread.
+    // The voice bank's registers are handed out one per task, the voices' envelopes and panning
+    // in tasks of at least minVoicesPerTask voices. Call this from the message thread, never the
+    // audio thread (it starts and stops threads). The output is bit-identical to the serial
+    // path either way.
+    void setRenderThreads(const int numWorkerThreads, const int minVoicesPerTask);
+
+    // Bit i is set while voice i is sounding, rendering only visits these voices
+    juce::uint64 getActiveVoiceMask() const noexcept { return voiceBank.getActiveVoiceMask(); }
+
+protected:
+    using juce::Synthesiser::renderVoices;
+    void renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples) override;
+
+private:
+    VoiceBank voiceBank;
+    VoiceThreadPool threadPool;
+    std::vector<SynthVoice*> synthVoices; // Our voices, in index order
+    std::vector<SynthVoice*> activeVoices; // Voices sounding in the current block, capacity reserved in prepareToPlay
+    std::vector<int> activeGroups; // Voice bank groups with a voice sounding, same
+    int maxBlockSize = 0; // Block size announced in prepareToPlay
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MaxSynthesiser)
+};
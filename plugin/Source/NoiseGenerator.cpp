@@ -0,0 +1,156 @@
+/*
+  ==============================================================================
+
+    NoiseGenerator.cpp
+    Created: 17 Oct 2026 5:02:19pm
+    Author:  max
+
+  ==============================================================================
+*/
+
+#include "NoiseGenerator.h"
+
+namespace
+{
+    using SIMDFloat = NoiseGenerator::SIMDFloat;
+    constexpr int laneWidth = NoiseGenerator::laneWidth;
+
+    // Turns the seed and a lane number into a well mixed, non-zero starting state (splitmix32)
+    juce::uint32 hashSeed(const juce::uint32 seed, const int lane) noexcept
+    {
+        auto x = seed + 0x9e3779b9u * static_cast<juce::uint32>(lane + 1);
+        x = (x ^ (x >> 16)) * 0x85ebca6bu;
+        x = (x ^ (x >> 13)) * 0xc2b2ae35u;
+        x ^= x >> 16;
+        return x != 0 ? x : 1u;
+    }
+
+    // Steps every lane's generator and writes uniform noise in -1..1. A fixed-length loop over
+    // plain integers, which the compiler turns into vector shifts and xors.
+    inline void nextWhite(juce::uint32* state, float* white) noexcept
+    {
+        for (int lane = 0; lane < laneWidth; ++lane)
+        {
+            auto x = state[lane];
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            state[lane] = x;
+
+            // Top 23 bits as the mantissa of a float in 1..2
+            const juce::uint32 bits = (x >> 9) | 0x3f800000u;
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            white[lane] = value * 2.0f - 3.0f;
+        }
+    }
+}
+
+NoiseGenerator::NoiseGenerator()
+{
+}
+
+void NoiseGenerator::prepare(const int lanes)
+{
+    numLanes = lanes;
+    jassert(numLanes % laneWidth == 0);
+
+    // Same layout as the voice bank: every array numLanes long, in one aligned block
+    const auto numArrays = 1 + 3 + 1;
+    stateMemory.calloc(static_cast<size_t>(numArrays * numLanes) * sizeof(float) + stateAlignment);
+
+    auto* data = juce::snapPointerToAlignment(reinterpret_cast<float*>(stateMemory.getData()), stateAlignment);
+
+    generators = reinterpret_cast<juce::uint32*>(data);
+    data += numLanes;
+
+    for (auto& stage : pinkStates)
+    {
+        stage = data;
+        data += numLanes;
+    }
+
+    brownStates = data;
+
+    reset();
+}
+
+void NoiseGenerator::setSeed(const juce::uint32 newSeed)
+{
+    seed = newSeed;
+    reset();
+}
+
+void NoiseGenerator::reset()
+{
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        generators[lane] = hashSeed(seed, lane);
+
+        for (auto* stage : pinkStates)
+            stage[lane] = 0.0f;
+
+        brownStates[lane] = 0.0f;
+    }
+}
+
+void NoiseGenerator::render(const Colour colour, const int firstLane, float* out, const int stride, const int numSamples)
+{
+    jassert(firstLane % laneWidth == 0 && firstLane < numLanes);
+
+    alignas(stateAlignment) float white[laneWidth];
+    auto* state = generators + firstLane;
+
+    if (colour == Colour::white)
+    {
+        for (int sample = 0; sample < numSamples; ++sample, out += stride)
+        {
+            nextWhite(state, white);
+            SIMDFloat::fromRawArray(white).copyToRawArray(out);
+        }
+
+        return;
+    }
+
+    if (colour == Colour::pink)
+    {
+        // Paul Kellet's economy pink filter: three one-pole lowpasses summed with the white input,
+        // within 0.05 dB of -3 dB/octave above ~40 Hz at 44.1 kHz. The final gain brings the RMS
+        // level back to that of the white noise.
+        auto b0 = SIMDFloat::fromRawArray(pinkStates[0] + firstLane);
+        auto b1 = SIMDFloat::fromRawArray(pinkStates[1] + firstLane);
+        auto b2 = SIMDFloat::fromRawArray(pinkStates[2] + firstLane);
+        const auto outputGain = SIMDFloat::expand(0.33f);
+
+        for (int sample = 0; sample < numSamples; ++sample, out += stride)
+        {
+            nextWhite(state, white);
+            const auto w = SIMDFloat::fromRawArray(white);
+
+            b0 = SIMDFloat::multiplyAdd(w * 0.0990460f, b0, SIMDFloat::expand(0.99765f));
+            b1 = SIMDFloat::multiplyAdd(w * 0.2965164f, b1, SIMDFloat::expand(0.96300f));
+            b2 = SIMDFloat::multiplyAdd(w * 1.0526913f, b2, SIMDFloat::expand(0.57000f));
+
+            (SIMDFloat::multiplyAdd(b0 + b1 + b2, w, SIMDFloat::expand(0.1848f)) * outputGain).copyToRawArray(out);
+        }
+
+        b0.copyToRawArray(pinkStates[0] + firstLane);
+        b1.copyToRawArray(pinkStates[1] + firstLane);
+        b2.copyToRawArray(pinkStates[2] + firstLane);
+        return;
+    }
+
+    // Brown: integrated white noise, -6 dB/octave. The leak keeps it from wandering off
+    // (and sets a corner around 10 Hz), the gain brings it back to the level of the white noise.
+    auto brown = SIMDFloat::fromRawArray(brownStates + firstLane);
+    const auto outputGain = SIMDFloat::expand(2.74f);
+
+    for (int sample = 0; sample < numSamples; ++sample, out += stride)
+    {
+        nextWhite(state, white);
+        brown = SIMDFloat::multiplyAdd(SIMDFloat::fromRawArray(white) * 0.02f, brown, SIMDFloat::expand(0.9985f));
+        (brown * outputGain).copyToRawArray(out);
+    }
+
+    brown.copyToRawArray(brownStates + firstLane);
+}
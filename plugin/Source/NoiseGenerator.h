@@ -0,0 +1,49 @@
+/*
+  ==============================================================================
+
+    NoiseGenerator.h
+    Created: 17 Oct 2026 5:02:19pm
+    Author:  max
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Noise for the voice bank: one xorshift32 generator per lane, so a whole SIMD register
+// of voices gets a fresh sample at once, plus pink and brown colouring filters that run
+// across the lanes in the same register. The output only depends on the seed and on the
+// order of calls, so two runs with the same seed and the same notes render the same noise.
+class NoiseGenerator
+{
+public:
+    using SIMDFloat = juce::dsp::SIMDRegister<float>;
+    static constexpr int laneWidth = static_cast<int>(SIMDFloat::size());
+
+    enum class Colour { white, pink, brown };
+
+    NoiseGenerator();
+    void prepare(const int numLanes);
+    void setSeed(const juce::uint32 newSeed);
+
+    // Renders numSamples for the lanes firstLane..firstLane + laneWidth - 1 into the interleaved
+    // block out (out[sample * stride + lane]), at roughly the level of a full scale sine
+    void render(const Colour colour, const int firstLane, float* out, const int stride, const int numSamples);
+
+private:
+    void reset();
+
+    juce::uint32 seed = 0x9e3779b9;
+    int numLanes = 0;
+
+    // Per-lane state, all arrays numLanes long and SIMD aligned
+    static constexpr size_t stateAlignment = 64;
+    juce::HeapBlock<char> stateMemory;
+    juce::uint32* generators = nullptr; // xorshift32 state, never 0
+    float* pinkStates[3] = {}; // The three one-pole stages of the pink filter
+    float* brownStates = nullptr; // Leaky integrator
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (NoiseGenerator)
+};
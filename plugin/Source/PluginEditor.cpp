@@ -21,7 +21,7 @@ MaxSynthAudioProcessorEditor::MaxSynthAudioProcessorEditor(MaxSynthAudioProcesso
       scopeComponent(audioProcessor.getAudioBufferQueue())
 {
     setLookAndFeel(&otherLookAndFeel);
-    setSize(1200, 500); // Increased height for three-row layout
+    setSize(1200, 630); // Increased height for three-row layout and the second filter
     setResizable(true, true);
     setResizeLimits(600, 400, 2000, 1500); // Increased minimum size
 
@@ -33,6 +33,7 @@ MaxSynthAudioProcessorEditor::MaxSynthAudioProcessorEditor(MaxSynthAudioProcesso
     addAndMakeVisible(adsrComponent);
     addAndMakeVisible(filterComponent);
     addAndMakeVisible(oscillatorComponent);
+    oscillatorComponent.onWavetableChosen = [this](int oscIndex, const juce::File& file) { return audioProcessor.loadWavetable(oscIndex, file); };
     addAndMakeVisible(lfoComponent);
 
     addAndMakeVisible (scopeComponent);
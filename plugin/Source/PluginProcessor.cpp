@@ -30,10 +30,38 @@ MaxSynthAudioProcessor::MaxSynthAudioProcessor()
     // Add multiple voices for polyphony (typically 8-16 voices)
     for (int i = 0; i < 10; ++i)
         synth.addVoice (new SynthVoice());
+
+    startTimer(250);
 }
 
 MaxSynthAudioProcessor::~MaxSynthAudioProcessor()
 {
+    stopTimer();
+}
+
+void MaxSynthAudioProcessor::timerCallback()
+{
+    const int renderThreads = static_cast<int>(*apvts.getRawParameterValue("renderThreads"));
+
+    if (renderThreads != appliedRenderThreads)
+    {
+        // Tasks of at least 2 voices, a single voice's envelope isn't worth waking a thread for
+        synth.setRenderThreads(renderThreads, 2);
+        appliedRenderThreads = renderThreads;
+    }
+
+    const int latency = getOversamplingLatency();
+
+    if (latency != reportedLatency)
+    {
+        setLatencySamples(latency);
+        reportedLatency = latency;
+    }
+}
+
+int MaxSynthAudioProcessor::getOversamplingLatency() const
+{
+    return VoiceBank::getLatency(1 << static_cast<int>(*apvts.getRawParameterValue("oversampling")));
 }
 
 //==============================================================================
@@ -101,11 +129,11 @@ void MaxSynthAudioProcessor::changeProgramName (int index, const juce::String& n
 //==============================================================================
 void MaxSynthAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {   
-    synth.setCurrentPlaybackSampleRate(sampleRate);
     midiCollector.reset(sampleRate);  // Add this line
     
     // Prepare global LFO
     currentSampleRate = sampleRate;
+    maxBlockSize = samplesPerBlock;
     globalLFOBuffer.resize(samplesPerBlock);
     
     juce::dsp::ProcessSpec spec;
@@ -116,14 +144,19 @@ void MaxSynthAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlo
     globalLFO.prepare(spec);
     globalLFO.setFrequency(2.0f); // Default frequency
 
-    for (int i = 0; i < synth.getNumVoices(); ++i)
+    for (int osc = 0; osc < VoiceBank::numOscillators; ++osc)
     {
-        if (auto* voice = dynamic_cast<SynthVoice*>(synth.getVoice(i)))
-        {
-            voice->prepareToPlay(sampleRate, samplesPerBlock, getTotalNumOutputChannels());
-        }
+        wavetablePositions[osc].reset(sampleRate, 0.02);
+        wavetablePositionBuffers[osc].resize(static_cast<size_t>(samplesPerBlock));
     }
+
+    // Prepares the voice bank and every voice
+    synth.prepareToPlay(sampleRate, samplesPerBlock, getTotalNumOutputChannels());
+    masterBus.prepareToPlay(sampleRate, samplesPerBlock, getTotalNumOutputChannels());
     synth.setNoteStealingEnabled(false);
+
+    reportedLatency = getOversamplingLatency();
+    setLatencySamples(reportedLatency);
     std::cout << synth.isNoteStealingEnabled() << std::endl;
 }
 
@@ -173,25 +206,74 @@ void MaxSynthAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juc
     // Get MIDI messages
     midiCollector.removeNextBlockOfMessages(midiMessages, buffer.getNumSamples());
 
+    // Wavetables that finished loading, picked up even while silent
+    wavetableLoader.applyPendingTables(synth.getVoiceBank());
+
+    // Nothing playing and nothing about to start: skip the whole engine
+    if (midiMessages.isEmpty() && synth.getActiveVoiceMask() == 0 && masterBus.isSilent())
+    {
+        buffer.clear();
+        scopeDataCollector.processSilence(static_cast<size_t>(buffer.getNumSamples()));
+        return;
+    }
+
     // Oscillator parameters
     auto& waveform = *apvts.getRawParameterValue("waveform");
     auto& waveform2 = *apvts.getRawParameterValue("waveform2");
     auto& waveform3 = *apvts.getRawParameterValue("waveform3");
 
+    auto& wavetablePosition = *apvts.getRawParameterValue("wavetablePosition");
+    auto& wavetablePosition2 = *apvts.getRawParameterValue("wavetablePosition2");
+    auto& wavetablePosition3 = *apvts.getRawParameterValue("wavetablePosition3");
+
+    auto& additivePartials = *apvts.getRawParameterValue("additivePartials");
+    auto& additiveTilt = *apvts.getRawParameterValue("additiveTilt");
+    auto& additiveEvenLevel = *apvts.getRawParameterValue("additiveEvenLevel");
+
+    auto& oscMode = *apvts.getRawParameterValue("oscMode");
+    auto& oscModulation = *apvts.getRawParameterValue("oscModulation");
+    auto& oscModAmount = *apvts.getRawParameterValue("oscModAmount");
+
     auto& osc1Enabled = *apvts.getRawParameterValue("osc1Enabled");
     auto& osc2Enabled = *apvts.getRawParameterValue("osc2Enabled");
     auto& osc3Enabled = *apvts.getRawParameterValue("osc3Enabled");
 
+    auto& osc1Pitch = *apvts.getRawParameterValue("osc1Pitch");
+    auto& osc2Pitch = *apvts.getRawParameterValue("osc2Pitch");
+    auto& osc3Pitch = *apvts.getRawParameterValue("osc3Pitch");
+
+    // Unison parameters
+    auto& osc1Unison = *apvts.getRawParameterValue("osc1Unison");
+    auto& osc1Detune = *apvts.getRawParameterValue("osc1Detune");
+    auto& osc1Spread = *apvts.getRawParameterValue("osc1Spread");
+    auto& osc1Blend = *apvts.getRawParameterValue("osc1Blend");
+    auto& osc2Unison = *apvts.getRawParameterValue("osc2Unison");
+    auto& osc2Detune = *apvts.getRawParameterValue("osc2Detune");
+    auto& osc2Spread = *apvts.getRawParameterValue("osc2Spread");
+    auto& osc2Blend = *apvts.getRawParameterValue("osc2Blend");
+    auto& osc3Unison = *apvts.getRawParameterValue("osc3Unison");
+    auto& osc3Detune = *apvts.getRawParameterValue("osc3Detune");
+    auto& osc3Spread = *apvts.getRawParameterValue("osc3Spread");
+    auto& osc3Blend = *apvts.getRawParameterValue("osc3Blend");
+
     // ADSR parameters
     auto& attack = *apvts.getRawParameterValue("attack");
     auto& decay = *apvts.getRawParameterValue("decay");
     auto& sustain = *apvts.getRawParameterValue("sustain");
     auto& release = *apvts.getRawParameterValue("release");
+    auto& curve = *apvts.getRawParameterValue("curve");
 
     // Filter parameters
     auto& filterCutoff = *apvts.getRawParameterValue("filterCutoff");
     auto& filterResonance = *apvts.getRawParameterValue("filterResonance");
     auto& filterMode = *apvts.getRawParameterValue("filterMode");
+    auto& filterType = *apvts.getRawParameterValue("filterType");
+    auto& filterMorph = *apvts.getRawParameterValue("filterMorph");
+    auto& filter2Routing = *apvts.getRawParameterValue("filter2Routing");
+    auto& filter2Cutoff = *apvts.getRawParameterValue("filter2Cutoff");
+    auto& filter2Resonance = *apvts.getRawParameterValue("filter2Resonance");
+    auto& filter2Mode = *apvts.getRawParameterValue("filter2Mode");
+    auto& oversampling = *apvts.getRawParameterValue("oversampling");
 
     // Get filter envelope and LFO parameters
     auto& filterADSREnabled = *apvts.getRawParameterValue("filterADSREnabled");
@@ -199,6 +281,7 @@ void MaxSynthAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juc
     auto& filterDecay = *apvts.getRawParameterValue("filterDecay");
     auto& filterSustain = *apvts.getRawParameterValue("filterSustain");
     auto& filterRelease = *apvts.getRawParameterValue("filterRelease");
+    auto& filterCurve = *apvts.getRawParameterValue("filterCurve");
     auto& adsrFilterAmount = *apvts.getRawParameterValue("adsrFilterAmount");
 
     // LFO parameters
@@ -206,41 +289,108 @@ void MaxSynthAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juc
     auto& lfoAmount = *apvts.getRawParameterValue("lfoAmount");
     auto& lfoTarget = *apvts.getRawParameterValue("lfoTarget");
 
+    // Stereo spread of the voices
+    auto& voiceSpread = *apvts.getRawParameterValue("voiceSpread");
+
+    // Level below which released voices are retired before their envelope has finished
+    auto& cullingFloor = *apvts.getRawParameterValue("cullingFloor");
+
+    // Master bus
+    auto& masterGain = *apvts.getRawParameterValue("masterGain");
+
     // Generate global LFO data for this block
     globalLFO.setFrequency(lfoFreq);
-    
-    // Resize buffer if needed
-    if (globalLFOBuffer.size() != buffer.getNumSamples())
-        globalLFOBuffer.resize(buffer.getNumSamples());
-    
-    // Generate LFO samples
-    for (int i = 0; i < buffer.getNumSamples(); ++i)
+
+    // The oscillators of all voices are rendered together by the voice bank
+    auto& voiceBank = synth.getVoiceBank();
+
+    // Only tell the bank about waveforms that actually changed
+    const int waveformChoices[] = { static_cast<int>(waveform), static_cast<int>(waveform2), static_cast<int>(waveform3) };
+
+    for (int osc = 0; osc < VoiceBank::numOscillators; ++osc)
     {
-        globalLFOBuffer[i] = globalLFO.processSample(0.0f);
+        if (waveformChoices[osc] != appliedWaveforms[osc])
+        {
+            voiceBank.updateWaveform(static_cast<VoiceBank::Waveform>(waveformChoices[osc]), osc + 1);
+            appliedWaveforms[osc] = waveformChoices[osc];
+        }
     }
 
+    // Unison (the voice bank ignores settings that haven't changed)
+    voiceBank.setUnison(1, static_cast<int>(osc1Unison), osc1Detune, osc1Spread, osc1Blend);
+    voiceBank.setUnison(2, static_cast<int>(osc2Unison), osc2Detune, osc2Spread, osc2Blend);
+    voiceBank.setUnison(3, static_cast<int>(osc3Unison), osc3Detune, osc3Spread, osc3Blend);
+
+    voiceBank.setOscEnabled(osc1Enabled, osc2Enabled, osc3Enabled);
+    voiceBank.setOscillatorMode(static_cast<VoiceBank::OscillatorMode>(static_cast<int>(oscMode)));
+    voiceBank.setModulation(static_cast<VoiceBank::Modulation>(static_cast<int>(oscModulation)), oscModAmount);
+    voiceBank.setFilterType(static_cast<VoiceBank::FilterType>(static_cast<int>(filterType)));
+    voiceBank.setFilterRouting(static_cast<VoiceBank::FilterRouting>(static_cast<int>(filter2Routing)));
+    voiceBank.setOversampling(1 << static_cast<int>(oversampling));
+
+    voiceBank.setOscPitch(1, osc1Pitch);
+    voiceBank.setOscPitch(2, osc2Pitch);
+    voiceBank.setOscPitch(3, osc3Pitch);
+
+    updateAdditiveSpectrum(static_cast<int>(additivePartials), additiveTilt, additiveEvenLevel);
+
+    wavetablePositions[0].setTargetValue(wavetablePosition);
+    wavetablePositions[1].setTargetValue(wavetablePosition2);
+    wavetablePositions[2].setTargetValue(wavetablePosition3);
+
     // Update each voice with the current parameters
     for (auto i = 0; i < synth.getNumVoices(); ++i)
     {
         if (auto* voice = dynamic_cast<SynthVoice*>(synth.getVoice(i)))
         {
-            voice->updateEnvelope(attack, decay, sustain, release);
-            voice->updateFilter(filterCutoff, filterResonance, static_cast<int>(filterMode));
-            voice->updateFilterEnvelope(filterAttack, filterDecay, filterSustain, filterRelease, filterADSREnabled > 0.5f, adsrFilterAmount);
-            voice->setGlobalLFOData(globalLFOBuffer.data(), lfoAmount); // Pass global LFO data
-            
-            if (osc1Enabled == true)
-                voice->updateWaveform(static_cast<int>(waveform), 1); // Update primary oscillator
-            if (osc2Enabled == true)
-                voice->updateWaveform(static_cast<int>(waveform2), 2); // Update secondary oscillator
-            if (osc3Enabled == true)
-                voice->updateWaveform(static_cast<int>(waveform3), 3); // Update tertiary oscillator
-
-            voice->setOscEnabled(osc1Enabled, osc2Enabled, osc3Enabled);
+            voice->updateEnvelope(attack, decay, sustain, release, curve);
+            voice->updateFilter(filterCutoff, filterResonance, static_cast<int>(filterMode), filterMorph);
+            voice->updateSecondFilter(filter2Cutoff, filter2Resonance, static_cast<int>(filter2Mode));
+            voice->updateFilterEnvelope(filterAttack, filterDecay, filterSustain, filterRelease, filterCurve, filterADSREnabled > 0.5f, adsrFilterAmount);
+
+            // Fan the voices out from the centre, alternating between left and right
+            const float side = (i % 2 == 0) ? -1.0f : 1.0f;
+            const float distance = static_cast<float>(i / 2 + 1) / static_cast<float>((synth.getNumVoices() + 1) / 2);
+            voice->setPan(voiceSpread * side * distance);
+            voice->setCullingFloor(cullingFloor);
         }
     }
 
-    synth.renderNextBlock(buffer, midiMessages, 0, buffer.getNumSamples());
+    // Render in slices no longer than the block size announced in prepareToPlay, so the
+    // global LFO buffer (and every voice's scratch memory) never has to grow on the audio thread
+    for (int chunkStart = 0; chunkStart < buffer.getNumSamples(); chunkStart += maxBlockSize)
+    {
+        const int chunkSize = juce::jmin(maxBlockSize, buffer.getNumSamples() - chunkStart);
+
+        // Generate LFO samples
+        for (int i = 0; i < chunkSize; ++i)
+        {
+            globalLFOBuffer[i] = globalLFO.processSample(0.0f);
+        }
+
+        for (auto i = 0; i < synth.getNumVoices(); ++i)
+        {
+            if (auto* voice = dynamic_cast<SynthVoice*>(synth.getVoice(i)))
+                voice->setGlobalLFOData(globalLFOBuffer.data(), chunkStart, lfoAmount); // Pass global LFO data
+        }
+
+        // Wavetable positions for every sample (anything modulating them at audio rate adds in here)
+        for (int osc = 0; osc < VoiceBank::numOscillators; ++osc)
+        {
+            auto& positions = wavetablePositionBuffers[osc];
+
+            for (int i = 0; i < chunkSize; ++i)
+                positions[static_cast<size_t>(i)] = wavetablePositions[osc].getNextValue();
+
+            voiceBank.setWavetablePositions(osc + 1, positions.data(), chunkStart);
+        }
+
+        synth.renderNextBlock(buffer, midiMessages, chunkStart, chunkSize);
+    }
+
+    // Gain, DC blocking and limiting on the finished mix
+    masterBus.setMasterGain(masterGain);
+    masterBus.process(buffer, 0, buffer.getNumSamples());
     
     // Collect scope data from the left channel (or mix down to mono)
     if (buffer.getNumChannels() > 0)
@@ -274,6 +424,48 @@ void MaxSynthAudioProcessor::setStateInformation (const void* data, int sizeInBy
     // whose contents will have been created by the getStateInformation() call.
 }
 
+void MaxSynthAudioProcessor::updateAdditiveSpectrum(const int numPartials, const float tilt, const float evenLevel)
+{
+    if (appliedAdditiveSettings[0] == static_cast<float>(numPartials) && appliedAdditiveSettings[1] == tilt && appliedAdditiveSettings[2] == evenLevel)
+        return;
+
+    appliedAdditiveSettings[0] = static_cast<float>(numPartials);
+    appliedAdditiveSettings[1] = tilt;
+    appliedAdditiveSettings[2] = evenLevel;
+
+    // Partial k at 1 / k^tilt (tilt 1 is a saw, with the even ones off a square), scaled to
+    // the loudness of a full scale sine
+    float amplitudes[VoiceBank::maxPartials] = {};
+    const int count = juce::jlimit(1, VoiceBank::maxPartials, numPartials);
+    float sumOfSquares = 0.0f;
+
+    for (int k = 1; k <= count; ++k)
+    {
+        auto& amplitude = amplitudes[k - 1];
+        amplitude = std::pow(static_cast<float>(k), -tilt) * (k % 2 == 0 ? evenLevel : 1.0f);
+        sumOfSquares += amplitude * amplitude;
+    }
+
+    juce::FloatVectorOperations::multiply(amplitudes, 1.0f / std::sqrt(sumOfSquares), count);
+
+    for (int osc = 1; osc <= VoiceBank::numOscillators; ++osc)
+        synth.getVoiceBank().setAdditiveSpectrum(osc, amplitudes, count);
+}
+
+bool MaxSynthAudioProcessor::loadWavetable(const int oscIndex, const juce::File& file)
+{
+    if (!wavetableLoader.load(oscIndex, file))
+        return false;
+
+    // The oscillator plays a sine (or its previous table) until the new one is ready
+    const juce::String parameterID = oscIndex == 1 ? juce::String("waveform") : "waveform" + juce::String(oscIndex);
+
+    if (auto* parameter = apvts.getParameter(parameterID))
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(static_cast<float>(VoiceBank::Waveform::wavetable)));
+
+    return true;
+}
+
 //==============================================================================
 // This creates new instances of the plugin..
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -286,24 +478,65 @@ juce::AudioProcessorValueTreeState::ParameterLayout MaxSynthAudioProcessor::crea
 {
     std::vector<std::unique_ptr<juce::RangedAudioParameter>> parameters;
 
-    // Waveform parameter (0=Sine, 1=Square, 2=Saw, 3=Triangle, 4=Noise)
+    // Waveform parameter (0=Sine, 1=Square, 2=Saw, 3=Triangle, 4=Noise, 5=Pink Noise, 6=Brown Noise, 7=Wavetable, 8=Additive)
     parameters.push_back(std::make_unique<juce::AudioParameterChoice>("waveform", "Waveform", 
-        juce::StringArray{"Sine", "Square", "Saw", "Triangle", "Noise"}, 0));
+        juce::StringArray{"Sine", "Square", "Saw", "Triangle", "Noise", "Pink Noise", "Brown Noise", "Wavetable", "Additive"}, 0));
     parameters.push_back(std::make_unique<juce::AudioParameterChoice>("waveform2", "Waveform 2", 
-        juce::StringArray{"Sine", "Square", "Saw", "Triangle", "Noise"}, 0));
+        juce::StringArray{"Sine", "Square", "Saw", "Triangle", "Noise", "Pink Noise", "Brown Noise", "Wavetable", "Additive"}, 0));
     parameters.push_back(std::make_unique<juce::AudioParameterChoice>("waveform3", "Waveform 3", 
-        juce::StringArray{"Sine", "Square", "Saw", "Triangle", "Noise"}, 0));
+        juce::StringArray{"Sine", "Square", "Saw", "Triangle", "Noise", "Pink Noise", "Brown Noise", "Wavetable", "Additive"}, 0));
+
+    // Position in a multi-frame wavetable, from the first frame (0) to the last (1)
+    parameters.push_back(std::make_unique<juce::AudioParameterFloat>("wavetablePosition", "Wavetable Position", 0.0f, 1.0f, 0.0f));
+    parameters.push_back(std::make_unique<juce::AudioParameterFloat>("wavetablePosition2", "Wavetable Position 2", 0.0f, 1.0f, 0.0f));
+    parameters.push_back(std::make_unique<juce::AudioParameterFloat>("wavetablePosition3", "Wavetable Position 3", 0.0f, 1.0f, 0.0f));
+
+    // Spectrum of the additive waveform, shared by all oscillators: partial k at 1 / k^tilt, the even ones scaled by the even level
+    parameters.push_back(std::make_unique<juce::AudioParameterInt>("additivePartials", "Additive Partials", 1, VoiceBank::maxPartials, 64));
+    parameters.push_back(std::make_unique<juce::AudioParameterFloat>("additiveTilt", "Additive Tilt", 0.0f, 2.0f, 1.0f));
+    parameters.push_back(std::make_unique<juce::AudioParameterFloat>("additiveEvenLevel", "Additive Even Level", 0.0f, 1.0f, 1.0f));
+
+    // How the oscillators generate their waveforms (see VoiceBank::OscillatorMode)
+    parameters.push_back(std::make_unique<juce::AudioParameterChoice>("oscMode", "Oscillator Mode",
+        juce::StringArray{"Wavetable", "PolyBLEP", "PolyBLEP 4-Point"}, 0));
 
     parameters.push_back(std::make_unique<juce::AudioParameterBool>("osc1Enabled", "OSC 1 Enabled", true));
     parameters.push_back(std::make_unique<juce::AudioParameterBool>("osc2Enabled", "OSC 2 Enabled", false));
     parameters.push_back(std::make_unique<juce::AudioParameterBool>("osc3Enabled", "OSC 3 Enabled", false));
 
+    // What OSC 2 does to OSC 1 (see VoiceBank::Modulation), the amount is the FM depth or the ring mod mix
+    parameters.push_back(std::make_unique<juce::AudioParameterChoice>("oscModulation", "Oscillator Modulation",
+        juce::StringArray{"Mix", "FM", "Ring Mod", "Hard Sync"}, 0));
+    parameters.push_back(std::make_unique<juce::AudioParameterFloat>("oscModAmount", "Modulation Amount", 0.0f, 1.0f, 0.5f));
+
+    // Transposition of each oscillator in semitones
+    parameters.push_back(std::make_unique<juce::AudioParameterInt>("osc1Pitch", "OSC 1 Pitch", -24, 24, 0));
+    parameters.push_back(std::make_unique<juce::AudioParameterInt>("osc2Pitch", "OSC 2 Pitch", -24, 24, 0));
+    parameters.push_back(std::make_unique<juce::AudioParameterInt>("osc3Pitch", "OSC 3 Pitch", -24, 24, 0));
+
+    // Unison parameters (number of detuned copies, detune in cents, stereo spread, level of the outer copies)
+    parameters.push_back(std::make_unique<juce::AudioParameterInt>("osc1Unison", "OSC 1 Unison", 1, VoiceBank::maxUnison, 1));
+    parameters.push_back(std::make_unique<juce::AudioParameterFloat>("osc1Detune", "OSC 1 Detune", 0.0f, 100.0f, 20.0f));
+    parameters.push_back(std::make_unique<juce::AudioParameterFloat>("osc1Spread", "OSC 1 Spread", 0.0f, 1.0f, 0.5f));
+    parameters.push_back(std::make_unique<juce::AudioParameterFloat>("osc1Blend", "OSC 1 Blend", 0.0f, 1.0f, 0.5f));
+    parameters.push_back(std::make_unique<juce::AudioParameterInt>("osc2Unison", "OSC 2 Unison", 1, VoiceBank::maxUnison, 1));
+    parameters.push_back(std::make_unique<juce::AudioParameterFloat>("osc2Detune", "OSC 2 Detune", 0.0f, 100.0f, 20.0f));
+    parameters.push_back(std::make_unique<juce::AudioParameterFloat>("osc2Spread", "OSC 2 Spread", 0.0f, 1.0f, 0.5f));
+    parameters.push_back(std::make_unique<juce::AudioParameterFloat>("osc2Blend", "OSC 2 Blend", 0.0f, 1.0f, 0.5f));
+    parameters.push_back(std::make_unique<juce::AudioParameterInt>("osc3Unison", "OSC 3 Unison", 1, VoiceBank::maxUnison, 1));
+    parameters.push_back(std::make_unique<juce::AudioParameterFloat>("osc3Detune", "OSC 3 Detune", 0.0f, 100.0f, 20.0f));
+    parameters.push_back(std::make_unique<juce::AudioParameterFloat>("osc3Spread", "OSC 3 Spread", 0.0f, 1.0f, 0.5f));
+    parameters.push_back(std::make_unique<juce::AudioParameterFloat>("osc3Blend", "OSC 3 Blend", 0.0f, 1.0f, 0.5f));
+
     // ADSR parameters
     parameters.push_back(std::make_unique<juce::AudioParameterFloat>("attack", "Attack", 0.001f, 1.0f, 0.01f));
     parameters.push_back(std::make_unique<juce::AudioParameterFloat>("decay", "Decay", 0.001f, 1.0f, 0.2f));
     parameters.push_back(std::make_unique<juce::AudioParameterFloat>("sustain", "Sustain", 0.0f, 1.0f, 0.7f));
     parameters.push_back(std::make_unique<juce::AudioParameterFloat>("release", "Release", 0.001f, 3.0f, 0.1f));
 
+    // Shape of the envelopes' stages, from straight lines (0) to analog-style exponentials (1)
+    parameters.push_back(std::make_unique<juce::AudioParameterFloat>("curve", "Curve", 0.0f, 1.0f, 0.0f));
+
     // Filter parameters
     parameters.push_back(std::make_unique<juce::AudioParameterFloat>("filterCutoff", "Filter Cutoff", 
         juce::NormalisableRange<float>(50.0f, 20000.0f, 0.1f, 0.3f), 20000.0f));
@@ -313,6 +546,27 @@ juce::AudioProcessorValueTreeState::ParameterLayout MaxSynthAudioProcessor::crea
     parameters.push_back(std::make_unique<juce::AudioParameterChoice>("filterMode", "Filter Mode", 
         juce::StringArray{"LPF 12dB", "LPF 24dB", "HPF 12dB", "HPF 24dB", "BPF 12dB", "BPF 24dB"}, 0));
 
+    // Filter type (0=Ladder, 1=State Variable). The state-variable filter ignores filterMode and
+    // morphs from low pass (0) through band pass (1) and high pass (2) to notch (3) instead.
+    parameters.push_back(std::make_unique<juce::AudioParameterChoice>("filterType", "Filter Type",
+        juce::StringArray{"Ladder", "State Variable"}, 0));
+    parameters.push_back(std::make_unique<juce::AudioParameterFloat>("filterMorph", "Filter Morph", 0.0f, 3.0f, 0.0f));
+
+    // Second filter of every voice, of the same type as the first (0=Off, 1=Serial, 2=Parallel).
+    // Its mode picks the state-variable filter's response too, it has no morph of its own.
+    parameters.push_back(std::make_unique<juce::AudioParameterChoice>("filter2Routing", "Filter 2 Routing",
+        juce::StringArray{"Off", "Serial", "Parallel"}, 0));
+    parameters.push_back(std::make_unique<juce::AudioParameterFloat>("filter2Cutoff", "Filter 2 Cutoff",
+        juce::NormalisableRange<float>(50.0f, 20000.0f, 0.1f, 0.3f), 20000.0f));
+    parameters.push_back(std::make_unique<juce::AudioParameterFloat>("filter2Resonance", "Filter 2 Resonance", 0.0f, 1.0f, 0.0f));
+    parameters.push_back(std::make_unique<juce::AudioParameterChoice>("filter2Mode", "Filter 2 Mode",
+        juce::StringArray{"LPF 12dB", "LPF 24dB", "HPF 12dB", "HPF 24dB", "BPF 12dB", "BPF 24dB"}, 0));
+
+    // Oversampling of the oscillators and filter (0=Off, 1=2x, 2=4x), only engaged for the voices
+    // whose resonance or pitch would alias
+    parameters.push_back(std::make_unique<juce::AudioParameterChoice>("oversampling", "Oversampling",
+        juce::StringArray{"Off", "2x", "4x"}, 0));
+
     
     // Filter ADSR parameters
     parameters.push_back(std::make_unique<juce::AudioParameterBool>("filterADSREnabled", "Filter ADSR Enabled", false));
@@ -320,12 +574,20 @@ juce::AudioProcessorValueTreeState::ParameterLayout MaxSynthAudioProcessor::crea
     parameters.push_back(std::make_unique<juce::AudioParameterFloat>("filterDecay", "Filter Decay", 0.01f, 1.0f, 0.0f));
     parameters.push_back(std::make_unique<juce::AudioParameterFloat>("filterSustain", "Filter Sustain", 0.0f, 1.0f, 0.0f));
     parameters.push_back(std::make_unique<juce::AudioParameterFloat>("filterRelease", "Filter Release", 0.0f, 1.0f, 0.0f));
+    parameters.push_back(std::make_unique<juce::AudioParameterFloat>("filterCurve", "Filter Curve", 0.0f, 1.0f, 0.0f));
 
     // LFO parameters
     parameters.push_back(std::make_unique<juce::AudioParameterFloat>("lfoFreq", "LFO Frequency", 0.1f, 20.0f, 2.0f));
     parameters.push_back(std::make_unique<juce::AudioParameterFloat>("lfoAmount", "LFO Amount", 0.0f, 1.0f, 0.0f)); // Default to 0.0 for no effect
 
     parameters.push_back(std::make_unique<juce::AudioParameterFloat>("masterGain", "Master Gain", 0.0f, 1.0f, 0.8f));
+    parameters.push_back(std::make_unique<juce::AudioParameterFloat>("voiceSpread", "Voice Spread", 0.0f, 1.0f, 0.0f)); // 0 = all voices centred
+    parameters.push_back(std::make_unique<juce::AudioParameterFloat>("cullingFloor", "Voice Culling Floor", -120.0f, -48.0f, -90.0f)); // dB
+
+    // Worker threads that render voices next to the audio thread, 0 renders everything on it.
+    // Not automatable: changing it starts and stops threads.
+    parameters.push_back(std::make_unique<juce::AudioParameterInt>("renderThreads", "Render Threads", 0, 7, 0,
+                                                                   juce::AudioParameterIntAttributes().withAutomatable(false)));
     parameters.push_back(std::make_unique<juce::AudioParameterFloat>("adsrFilterAmount", "ADSR Filter Amount", 0.0f, 1.0f, 0.0f));
 
     return { parameters.begin(), parameters.end() };
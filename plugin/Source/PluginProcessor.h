@@ -10,11 +10,16 @@
 
 #include <JuceHeader.h>
 #include "../Components/ScopeComponent.h"
+#include "MaxSynthesiser.h"
+#include "MasterBus.h"
+#include "WavetableLoader.h"
+#include "FastMath.h"
 
 //==============================================================================
 /**
 */
-class MaxSynthAudioProcessor  : public juce::AudioProcessor
+class MaxSynthAudioProcessor  : public juce::AudioProcessor,
+                                private juce::Timer
 {
 public:
     //==============================================================================
@@ -63,8 +68,16 @@ public:
     // Global LFO access
     const float* getGlobalLFOBuffer() const noexcept { return globalLFOBuffer.data(); }
 
+    juce::uint64 getActiveVoiceMask() const noexcept { return synth.getActiveVoiceMask(); }
+
+    // Loads a WAV wavetable into an oscillator (1-based) and switches it to the Wavetable waveform.
+    // Message thread only, false if the file can't be used.
+    bool loadWavetable(const int oscIndex, const juce::File& file);
+
 private:
-    juce::Synthesiser synth; 
+    MaxSynthesiser synth; 
+    MasterBus masterBus;
+    WavetableLoader wavetableLoader;
     juce::AudioProcessorValueTreeState apvts;
 
     juce::MidiMessageCollector midiCollector;
@@ -74,10 +87,30 @@ private:
     AudioBufferQueue<float> audioBufferQueue;
     ScopeDataCollector<float> scopeDataCollector { audioBufferQueue };
     
-    // Global LFO
-    juce::dsp::Oscillator<float> globalLFO { [](float x) { return std::sin(x); } };
+    // Global LFO (it only moves the filter cutoff, the medium accuracy sine is plenty)
+    juce::dsp::Oscillator<float> globalLFO { [](float x) { return FastMath::sin<FastMath::Accuracy::medium>(x); } };
     std::vector<float> globalLFOBuffer;
+
+    // Wavetable positions, smoothed into a value per sample for the voice bank
+    juce::SmoothedValue<float> wavetablePositions[VoiceBank::numOscillators];
+    std::vector<float> wavetablePositionBuffers[VoiceBank::numOscillators];
     double currentSampleRate = 44100.0;
+    int maxBlockSize = 512; // Block size announced in prepareToPlay
+    int appliedWaveforms[VoiceBank::numOscillators] = { -1, -1, -1 }; // Waveform choices the voice bank was last given
+
+    // Starts and stops the render worker threads when the renderThreads parameter changes. A timer
+    // on the message thread, the audio thread must never wait for a thread to start or stop.
+    void timerCallback() override;
+    int appliedRenderThreads = 0; // Worker threads the synth was last given, it starts without any
+
+    // Latency the voice bank will have at the oversampling parameter's factor. The timer and
+    // prepareToPlay report it to the host, setLatencySamples isn't for the audio thread.
+    int getOversamplingLatency() const;
+    int reportedLatency = 0; // Latency the host was last told about
+
+    // Rebuilds the additive spectrum if its parameters changed since the last block
+    void updateAdditiveSpectrum(const int numPartials, const float tilt, const float evenLevel);
+    float appliedAdditiveSettings[3] = { -1.0f, -1.0f, -1.0f }; // Partials, tilt and even level of the current spectrum
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MaxSynthAudioProcessor)
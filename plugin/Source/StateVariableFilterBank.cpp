@@ -0,0 +1,277 @@
+/*
+  ==============================================================================
+
+    StateVariableFilterBank.cpp
+    Created: 18 Oct 2026 12:46:31am
+    Author:  max
+
+  ==============================================================================
+*/
+
+#include "StateVariableFilterBank.h"
+#include "FastMath.h"
+
+namespace
+{
+    using SIMDFloat = StateVariableFilterBank::SIMDFloat;
+
+    constexpr double rampSeconds = 0.05;
+    constexpr float maxDamping = juce::MathConstants<float>::sqrt2;
+    constexpr float maxHalfCycle = 0.2475f; // Keeps the cutoff below 0.495 fs, where tan runs off to infinity
+
+    // Q from 0.707 (no peak) at no resonance up to about 70
+    float getDamping(const float resonance) noexcept
+    {
+        return maxDamping * (1.0f - 0.99f * juce::jlimit(0.0f, 1.0f, resonance));
+    }
+
+    float slew(const float current, const float target, const float maxChange) noexcept
+    {
+        return current + juce::jlimit(-maxChange, maxChange, target - current);
+    }
+
+    // Weights of the low, band and high outputs for a morph position. Notch is low plus high.
+    void getMorphWeights(const float morph, float (&weights)[3]) noexcept
+    {
+        using Bank = StateVariableFilterBank;
+        const float notchWeight = juce::jmax(0.0f, morph - Bank::highPass);
+
+        weights[0] = juce::jmax(0.0f, 1.0f - std::abs(morph - Bank::lowPass)) + notchWeight;
+        weights[1] = juce::jmax(0.0f, 1.0f - std::abs(morph - Bank::bandPass));
+        weights[2] = juce::jmax(0.0f, 1.0f - std::abs(morph - Bank::highPass)) + notchWeight;
+    }
+}
+
+void StateVariableFilterBank::prepare(double sampleRate, int maxBlockSize, int lanes)
+{
+    currentSampleRate = sampleRate;
+    numLanes = ((lanes + laneWidth - 1) / laneWidth) * laneWidth;
+    rampLength = juce::jmax(1, static_cast<int>(rampSeconds * sampleRate));
+
+    // Same single aligned allocation as the voice bank: every array is a whole number of registers
+    const int numRows = 4 + 4 + maxBlockSize;
+    stateMemory.calloc(static_cast<size_t>(numRows * numLanes) * sizeof(float) + stateAlignment);
+    auto* data = juce::snapPointerToAlignment(reinterpret_cast<float*>(stateMemory.getData()), stateAlignment);
+
+    for (auto& channel : integrators)
+    {
+        for (auto& integrator : channel)
+        {
+            integrator = data;
+            data += numLanes;
+        }
+    }
+
+    for (auto** row : { &damping, &dampingTargets, &morphs, &morphTargets })
+    {
+        *row = data;
+        data += numLanes;
+    }
+
+    cutoffs = data;
+    oversamplingFactors.assign(static_cast<size_t>(numLanes), 1);
+
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        setResonance(lane, 0.0f);
+        setMorph(lane, lowPass);
+        reset(lane);
+
+        for (int sample = 0; sample < maxBlockSize; ++sample)
+            setCutoff(lane, sample, 1000.0f);
+    }
+}
+
+void StateVariableFilterBank::reset(const int lane)
+{
+    for (auto& channel : integrators)
+        for (auto* integrator : channel)
+            integrator[lane] = 0.0f;
+
+    damping[lane] = dampingTargets[lane];
+    morphs[lane] = morphTargets[lane];
+}
+
+void StateVariableFilterBank::setResonance(const int lane, const float resonance)
+{
+    dampingTargets[lane] = getDamping(resonance);
+}
+
+void StateVariableFilterBank::setMorph(const int lane, const float morph)
+{
+    morphTargets[lane] = juce::jlimit(lowPass, notch, morph);
+}
+
+bool StateVariableFilterBank::isTransparent(const int lane, const int startSample, const int numSamples, const float minCutoffHz) const noexcept
+{
+    if (morphs[lane] != lowPass || morphTargets[lane] != lowPass || damping[lane] != maxDamping || dampingTargets[lane] != maxDamping)
+        return false;
+
+    for (int sample = startSample; sample < startSample + numSamples; ++sample)
+        if (cutoffs[sample * numLanes + lane] < minCutoffHz)
+            return false;
+
+    return true;
+}
+
+void StateVariableFilterBank::setOversampling(const int firstLane, const int factor)
+{
+    // Nothing to convert, the integrator states mean the same at any rate
+    for (int lane = firstLane; lane < firstLane + laneWidth; ++lane)
+        oversamplingFactors[static_cast<size_t>(lane)] = factor;
+}
+
+StateVariableFilterBank::LaneGroup::LaneGroup(StateVariableFilterBank& owner, const int first, const int startSample,
+                                               const int numSamples, const int channels) noexcept
+    : bank(owner), firstLane(first), numChannels(channels)
+{
+    jassert(numSamples <= maxChunkSize);
+    const int factor = bank.oversamplingFactors[static_cast<size_t>(firstLane)];
+
+    // Resonance and morph move at most this far over the chunk, and glide there sample by sample
+    const float perSample = 1.0f / static_cast<float>(numSamples);
+    const auto rampSamples = static_cast<float>(bank.rampLength * factor);
+    const float maxDampingChange = maxDamping * static_cast<float>(numSamples) / rampSamples;
+    const float maxMorphChange = (notch - lowPass) * static_cast<float>(numSamples) / rampSamples;
+
+    alignas(stateAlignment) float dampingStarts[laneWidth], dampingSteps[laneWidth];
+    alignas(stateAlignment) float weightStarts[3][laneWidth], weightSteps[3][laneWidth];
+
+    for (int i = 0; i < laneWidth; ++i)
+    {
+        const int lane = firstLane + i;
+        const float dampingEnd = slew(bank.damping[lane], bank.dampingTargets[lane], maxDampingChange);
+        dampingStarts[i] = bank.damping[lane];
+        dampingSteps[i] = (dampingEnd - bank.damping[lane]) * perSample;
+        bank.damping[lane] = dampingEnd;
+
+        float startWeights[3], endWeights[3];
+        getMorphWeights(bank.morphs[lane], startWeights);
+        bank.morphs[lane] = slew(bank.morphs[lane], bank.morphTargets[lane], maxMorphChange);
+        getMorphWeights(bank.morphs[lane], endWeights);
+
+        for (int output = 0; output < 3; ++output)
+        {
+            weightStarts[output][i] = startWeights[output];
+            weightSteps[output][i] = (endWeights[output] - startWeights[output]) * perSample;
+        }
+    }
+
+    // The coefficients of every sample and lane in one flat loop, which the compiler vectorises
+    // (SIMDRegister has no division). g = tan(pi fc / fs), with tan as sin / cos of the half cycle.
+    const float halfCycleScale = static_cast<float>(0.5 / (bank.currentSampleRate * factor));
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        const float* sampleCutoffs = bank.cutoffs + (startSample + sample / factor) * bank.numLanes + firstLane;
+
+        for (int i = 0; i < laneWidth; ++i)
+        {
+            const float halfCycle = juce::jmin(maxHalfCycle, sampleCutoffs[i] * halfCycleScale);
+            const float g = FastMath::sin2pi(halfCycle) / FastMath::sin2pi(0.25f - halfCycle);
+            const float damp = dampingStarts[i] + dampingSteps[i] * static_cast<float>(sample + 1);
+            const float a = 1.0f / (1.0f + g * (g + damp));
+
+            const int index = sample * laneWidth + i;
+            a1s[index] = a;
+            a2s[index] = g * a;
+            a3s[index] = g * g * a;
+            ks[index] = damp;
+        }
+    }
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        ic1[channel] = SIMDFloat::fromRawArray(bank.integrators[channel][0] + firstLane);
+        ic2[channel] = SIMDFloat::fromRawArray(bank.integrators[channel][1] + firstLane);
+    }
+
+    for (int output = 0; output < 3; ++output)
+    {
+        weights[output] = SIMDFloat::fromRawArray(weightStarts[output]);
+        weightDeltas[output] = SIMDFloat::fromRawArray(weightSteps[output]);
+    }
+}
+
+void StateVariableFilterBank::LaneGroup::store() const noexcept
+{
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        ic1[channel].copyToRawArray(bank.integrators[channel][0] + firstLane);
+        ic2[channel].copyToRawArray(bank.integrators[channel][1] + firstLane);
+    }
+}
+
+void StateVariableFilterBank::LaneGroup::nextSample(const int sample) noexcept
+{
+    const int index = sample * laneWidth;
+    a1 = SIMDFloat::fromRawArray(a1s + index);
+    a2 = SIMDFloat::fromRawArray(a2s + index);
+    a3 = SIMDFloat::fromRawArray(a3s + index);
+    k = SIMDFloat::fromRawArray(ks + index);
+
+    for (auto output = 0; output < 3; ++output)
+        weights[output] += weightDeltas[output];
+}
+
+SIMDFloat StateVariableFilterBank::LaneGroup::filter(const int channel, const SIMDFloat v0) noexcept
+{
+    const auto v3 = v0 - ic2[channel];
+    const auto v1 = a1 * ic1[channel] + a2 * v3;
+    const auto v2 = ic2[channel] + a2 * ic1[channel] + a3 * v3;
+    ic1[channel] = v1 * 2.0f - ic1[channel];
+    ic2[channel] = v2 * 2.0f - ic2[channel];
+
+    const auto high = v0 - k * v1 - v2;
+    return weights[0] * v2 + weights[1] * v1 + weights[2] * high;
+}
+
+void StateVariableFilterBank::process(const int firstLane, const int startSample, float* left, float* right, const int stride, const int numSamples)
+{
+    const int numChannels = right != nullptr ? 2 : 1;
+    float* channels[2] = { left, right };
+    LaneGroup lanes(*this, firstLane, startSample, numSamples, numChannels);
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        lanes.nextSample(sample);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            float* io = channels[channel] + sample * stride;
+            lanes.filter(channel, SIMDFloat::fromRawArray(io)).copyToRawArray(io);
+        }
+    }
+
+    lanes.store();
+}
+
+void StateVariableFilterBank::processPair(const int firstLane, const int secondLane, const int startSample, const bool serial,
+                                          float* left, float* right, const int stride, const int numSamples)
+{
+    const int numChannels = right != nullptr ? 2 : 1;
+    float* channels[2] = { left, right };
+    LaneGroup first(*this, firstLane, startSample, numSamples, numChannels);
+    LaneGroup second(*this, secondLane, startSample, numSamples, numChannels);
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        first.nextSample(sample);
+        second.nextSample(sample);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            float* io = channels[channel] + sample * stride;
+            const auto input = SIMDFloat::fromRawArray(io);
+            const auto firstOutput = first.filter(channel, input);
+
+            const auto output = serial ? second.filter(channel, firstOutput)
+                                       : (firstOutput + second.filter(channel, input)) * 0.5f;
+
+            output.copyToRawArray(io);
+        }
+    }
+
+    first.store();
+    second.store();
+}
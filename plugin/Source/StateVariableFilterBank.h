@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+    StateVariableFilterBank.h
+    Created: 18 Oct 2026 12:46:31am
+    Author:  max
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Zero-delay-feedback (topology-preserving transform) state-variable filters for all voices,
+// one voice per SIMD lane like LadderFilterBank. Low, band, high and notch come out of the
+// same two integrators, and the morph control blends continuously between them.
+//
+// Unlike the ladder, retuning costs a tan and a division per sample, done for a whole chunk
+// of lanes in one vectorised pass. So the cutoff is given for every sample, and envelopes
+// and LFOs move it without steps. Resonance and morph glide to new settings over 50 ms.
+//
+// Like the ladders, two registers of lanes can run as a voice's pair of filters in one pass.
+class StateVariableFilterBank
+{
+public:
+    using SIMDFloat = juce::dsp::SIMDRegister<float>;
+    static constexpr int laneWidth = static_cast<int>(SIMDFloat::size());
+    static constexpr int maxChunkSize = 32; // Longest stretch process takes at once
+
+    // Morph positions of the pure responses, the values in between crossfade neighbours
+    static constexpr float lowPass = 0.0f, bandPass = 1.0f, highPass = 2.0f, notch = 3.0f;
+
+    StateVariableFilterBank() = default;
+    void prepare(double sampleRate, int maxBlockSize, int numLanes);
+
+    // Clears a lane's state and moves its resonance and morph straight to their targets
+    void reset(const int lane);
+
+    void setResonance(const int lane, const float resonance); // 0..1, self-oscillates just short of 1
+    void setMorph(const int lane, const float morph); // lowPass..notch
+
+    // Cutoff of a lane for one sample of the coming block
+    void setCutoff(const int lane, const int sample, const float cutoffHz) noexcept { cutoffs[sample * numLanes + lane] = cutoffHz; }
+
+    // True if a lane would pass the numSamples samples of the coming block from startSample on through
+    // all but unchanged: a settled low pass with no resonance, and the cutoff at minCutoffHz or above
+    bool isTransparent(const int lane, const int startSample, const int numSamples, const float minCutoffHz) const noexcept;
+
+    // Rate the lanes firstLane..firstLane + laneWidth - 1 run at, as a multiple of the sample rate
+    void setOversampling(const int firstLane, const int factor);
+
+    // Filters numSamples samples of the lanes firstLane..firstLane + laneWidth - 1 in place, starting
+    // at sample startSample of the block. Oversampled lanes take factor samples per sample of the
+    // block (and its cutoff). Channel c of sample s is at channels[c][s * stride]; right is null for
+    // a mono block.
+    void process(const int firstLane, const int startSample, float* left, float* right, const int stride, const int numSamples);
+
+    // Like process, but for the lanes firstLane.. and secondLane.. together as two filters of the
+    // same voices: in series, the first one's output feeding the second, or in parallel on the same
+    // input with their outputs averaged
+    void processPair(const int firstLane, const int secondLane, const int startSample, const bool serial,
+                     float* left, float* right, const int stride, const int numSamples);
+
+private:
+    static constexpr size_t stateAlignment = 64;
+
+    // A register of lanes while they filter a chunk. Loading it works out the coefficients of every
+    // sample of the chunk, and moves the lanes' resonance and morph on by the chunk.
+    struct LaneGroup
+    {
+        LaneGroup(StateVariableFilterBank& bank, const int firstLane, const int startSample, const int numSamples, const int numChannels) noexcept;
+        void store() const noexcept;
+
+        // Loads a sample's coefficients and steps the output mix, once per sample for both channels
+        void nextSample(const int sample) noexcept;
+        SIMDFloat filter(const int channel, const SIMDFloat input) noexcept;
+
+        StateVariableFilterBank& bank;
+        const int firstLane, numChannels;
+        alignas(stateAlignment) float a1s[maxChunkSize * laneWidth], a2s[maxChunkSize * laneWidth];
+        alignas(stateAlignment) float a3s[maxChunkSize * laneWidth], ks[maxChunkSize * laneWidth];
+        SIMDFloat a1, a2, a3, k;
+        SIMDFloat weights[3], weightDeltas[3];
+        SIMDFloat ic1[2], ic2[2];
+    };
+
+    double currentSampleRate = 44100.0;
+    int numLanes = 0;
+    int rampLength = 1; // Samples a full sweep of resonance or morph takes at the sample rate
+
+    juce::HeapBlock<char> stateMemory;
+    float* integrators[2][2] = {}; // Integrator states (ic1eq, ic2eq) per channel, numLanes long
+    float* damping = nullptr; // k = 1 / Q per lane, and where it is heading
+    float* dampingTargets = nullptr;
+    float* morphs = nullptr; // Morph per lane, and where it is heading
+    float* morphTargets = nullptr;
+    float* cutoffs = nullptr; // cutoffs[sample * numLanes + lane] in Hz
+    std::vector<int> oversamplingFactors; // Per lane, see setOversampling
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StateVariableFilterBank)
+};
@@ -10,13 +10,15 @@
 
 #include "SynthVoice.h"
 
-SynthVoice::SynthVoice()
+namespace
 {
-    // Initialize the oscillator and gain
-    gain.setGainLinear(volume);
+    // The level the culling test compares against is the peak of at least this much of the
+    // note, so a short block or a slow waveform passing through zero can't make it look silent
+    constexpr double peakWindowSeconds = 0.1;
+}
 
-    // Initialize with sine wave
-    updateWaveform(0, 1);
+SynthVoice::SynthVoice()
+{
 }
 
 SynthVoice::~SynthVoice()
@@ -29,27 +31,25 @@ void SynthVoice::prepareToPlay(double sampleRate, int samplesPerBlock, int numCh
     juce::dsp::ProcessSpec spec;
     spec.sampleRate = sampleRate;
     spec.maximumBlockSize = static_cast<juce::uint32>(samplesPerBlock);
-    spec.numChannels = numChannels;
-
-    // Prepare the DSP components
-    oscillator1.prepare(spec);
-    oscillator1.setFrequency(freq);
-    oscillator2.prepare(spec);
-    oscillator2.setFrequency(freq);
-    oscillator3.prepare(spec);
-    oscillator3.setFrequency(freq);
+    spec.numChannels = 2; // Voices are mono unless unison spreads them, and panned into the output afterwards
 
-    gain.prepare(spec);
-    gain.setGainLinear(volume);
+    juce::ignoreUnused(numChannels);
 
+    // Prepare the DSP components (the oscillators and the filter live in the voice bank)
     adsr.setSampleRate(sampleRate);
     filterADSR.setSampleRate(sampleRate);
+    peakWindowLength = juce::jmax(1, static_cast<int>(peakWindowSeconds * sampleRate));
+
+    jassert(voiceBank != nullptr);
 
-    filter.prepare(spec);
-    filter.setMode(juce::dsp::LadderFilterMode::LPF12);
-    filter.setCutoffFrequencyHz(baseCutoff);
-    filter.setResonance(baseResonance);
-    filter.setEnabled(true);
+    for (int filter = 0; filter < VoiceBank::numFilters; ++filter)
+        voiceBank->setVoiceResonance(voiceIndex, filter, baseResonances[filter]);
+
+    // Allocate the scratch arena, the voice's channels plus one for the amp envelope. Rounding the
+    // length up to a multiple of 16 floats keeps every channel (not just the first) starting on a
+    // cache line boundary.
+    const auto scratchSamples = (static_cast<size_t>(samplesPerBlock) + 15) & ~static_cast<size_t>(15);
+    scratchBlock = juce::dsp::AudioBlock<float>(scratchMemory, spec.numChannels + 1, scratchSamples, scratchAlignment);
 }
 
 bool SynthVoice::canPlaySound(juce::SynthesiserSound *sound)
@@ -67,26 +67,25 @@ void SynthVoice::startNote(int midiNoteNumber, float velocity, juce::Synthesiser
     // Start the note with the given MIDI note number and velocity
     freq = juce::MidiMessage::getMidiNoteInHertz(midiNoteNumber);
     
-    // Reset oscillator phases to avoid frequency sweeps
-    oscillator1.reset();
-    oscillator2.reset();
-    oscillator3.reset();
-    
-    // Set frequencies
-    oscillator1.setFrequency(freq, true);
-    oscillator2.setFrequency(freq, true);
-    oscillator3.setFrequency(freq, true);
-
-    // Set gain based on velocity to prevent clipping
-    gain.setGainLinear(velocity * 0.3f);
+    // Reset oscillator phases and set frequencies, with the gain based on velocity to prevent clipping
+    jassert(voiceBank != nullptr);
+    voiceBank->startVoice(voiceIndex, freq, velocity * 0.3f);
     
     // Reset filter state to avoid frequency sweeps
-    filter.reset();
-    
-    // Initialize filter with base cutoff to ensure consistent starting point
-    filter.setCutoffFrequencyHz(baseCutoff);
+    for (int filter = 0; filter < VoiceBank::numFilters; ++filter)
+    {
+        const int lane = voiceBank->getFilterLane(voiceIndex, filter);
+        voiceBank->getLadderFilters().reset(lane);
+        voiceBank->getStateVariableFilters().reset(lane);
+        lastEnvelopeCutoffs[filter] = baseCutoffs[filter];
+    }
 
-    // NOW start the envelopes (after everything is reset)
+    // NOW start the envelopes (after everything is reset). The amp envelope starts once the
+    // note comes out of the voice bank, which is later while it oversamples.
+    isReleasing = false;
+    envelopeDelay = voiceBank->getLatency();
+    peakWindows[0] = peakWindows[1] = 0.0f;
+    peakWindowSamples = 0;
     adsr.noteOn();
     filterADSR.noteOn(); // Start filter envelope
 }
@@ -96,13 +95,14 @@ void SynthVoice::stopNote(float velocity, bool allowTailOff)
     // Stop the note with the given velocity
     adsr.noteOff();
     filterADSR.noteOff();
+    isReleasing = true;
     
     // If not allowing tail off, force immediate stop
     if (!allowTailOff)
     {
         adsr.reset();
         filterADSR.reset();
-        clearCurrentNote(); // Mark voice as not playing any note
+        finishNote(); // Mark voice as not playing any note
     }
 }
 
@@ -117,199 +117,307 @@ void SynthVoice::controllerMoved(int controllerNumber, int newValue)
 }
 
 void SynthVoice::renderNextBlock(juce::AudioBuffer<float> &outputBuffer, int startSample, int numSamples)
+{
+    renderVoice(startSample, numSamples);
+    mixInto(outputBuffer, startSample, numSamples);
+}
+
+void SynthVoice::renderVoice(int startSample, int numSamples)
 {
     // Check if the voice should be playing
-    if (!isVoiceActive())
+    hasRenderedBlock = isVoiceActive();
+
+    if (!hasRenderedBlock)
         return;
 
-    // Create a buffer for just the samples we need to render
-    juce::AudioBuffer<float> synthBuffer(outputBuffer.getNumChannels(), numSamples);
-    synthBuffer.clear();
+    // MaxSynthesiser never asks for more than the scratch arena (and the voice bank) can hold
+    jassert(numSamples <= static_cast<int>(scratchBlock.getNumSamples()));
+
+    // Use the part of the scratch arena we need for this block (mono, or stereo for spread unison)
+    numRenderedChannels = voiceBank->isStereo() ? 2 : 1;
+    auto synthBlock = scratchBlock.getSubsetChannelBlock(0, static_cast<size_t>(numRenderedChannels)).getSubBlock(0, static_cast<size_t>(numSamples));
 
-    // Create audio block for processing
-    juce::dsp::AudioBlock<float> synthBlock(synthBuffer);
-    juce::dsp::ProcessContextReplacing<float> synthContext(synthBlock);
+    // Fetch this voice's filtered oscillator output (velocity gain included) from the voice bank
+    voiceBank->copyVoiceOutput(voiceIndex, synthBlock.getChannelPointer(0),
+                               numRenderedChannels > 1 ? synthBlock.getChannelPointer(1) : nullptr, numSamples);
 
-    // Generate oscillator output
-    if (osc1Enabled)
-        oscillator1.process(synthContext);
-    if (osc2Enabled)
-        oscillator2.process(synthContext);
-    if (osc3Enabled)
-        oscillator3.process(synthContext);
+    // Apply ADSR envelope, after any samples from before the note
+    float envelopeLevel = 0.0f;
+    const int delayedSamples = juce::jmin(envelopeDelay, numSamples);
+    const int envelopeSamples = numSamples - delayedSamples;
+    envelopeDelay -= delayedSamples;
+
+    for (int channel = 0; channel < numRenderedChannels; ++channel)
+        juce::FloatVectorOperations::clear(synthBlock.getChannelPointer(static_cast<size_t>(channel)), delayedSamples);
+
+    if (envelopeSamples > 0)
+    {
+        // Level of the note before the envelope, used to predict what is left of the release tail
+        float signalPeak = 0.0f;
+
+        for (int channel = 0; channel < numRenderedChannels; ++channel)
+        {
+            const auto signalRange = juce::FloatVectorOperations::findMinAndMax(synthBlock.getChannelPointer(static_cast<size_t>(channel)) + delayedSamples, envelopeSamples);
+            signalPeak = juce::jmax(signalPeak, -signalRange.getStart(), signalRange.getEnd());
+        }
 
-    // Apply gain
-    gain.process(synthContext);
+        holdPeak(signalPeak, envelopeSamples);
+
+        // The envelope a segment at a time into its own scratch channel, then one multiply per channel
+        auto* envelopeData = scratchBlock.getChannelPointer(envelopeChannel);
+        adsr.render(envelopeData, envelopeSamples);
+        envelopeLevel = envelopeData[envelopeSamples - 1];
+
+        for (int channel = 0; channel < numRenderedChannels; ++channel)
+            juce::FloatVectorOperations::multiply(synthBlock.getChannelPointer(static_cast<size_t>(channel)) + delayedSamples, envelopeData, envelopeSamples);
+    }
+
+    // Clear the voice if the envelope has finished (this block still gets mixed). A released
+    // envelope only falls from here on, so once envelope * signal level is below the floor
+    // the rest of the tail can't be heard either and the voice can retire early. Not before the
+    // envelope has started though: a note still hidden by the oversampling latency has no level yet.
+    const float heldPeak = juce::jmax(peakWindows[0], peakWindows[1]);
+
+    if (!adsr.isActive() || (isReleasing && envelopeSamples > 0 && envelopeLevel * heldPeak < cullingFloorGain))
+        finishNote();
+}
+
+void SynthVoice::holdPeak(const float peak, const int numSamples)
+{
+    // Two windows of peakWindowLength samples: the one filling up and the last full one
+    peakWindows[1] = juce::jmax(peakWindows[1], peak);
+    peakWindowSamples += numSamples;
+
+    if (peakWindowSamples >= peakWindowLength)
+    {
+        peakWindows[0] = peakWindows[1];
+        peakWindows[1] = 0.0f;
+        peakWindowSamples = 0;
+    }
+}
+
+void SynthVoice::updateFilterCutoffs(int startSample, int numSamples)
+{
+    if (!isVoiceActive())
+        return;
+
+    // The state-variable filter takes a cutoff for every sample, the ladder one per control interval
+    const bool sampleAccurate = voiceBank->getFilterType() == VoiceBank::FilterType::stateVariable;
+
+    // The second filter only needs cutoffs while it is heard
+    const int numFilters = voiceBank->getFilterRouting() == VoiceBank::FilterRouting::off ? 1 : VoiceBank::numFilters;
 
-    // TODO Make this block its own function
     // Use global LFO data if available, otherwise fall back to local generation
-    const float* lfoData = globalLFOData;
+    // The global LFO buffer starts at globalLFOStartSample in the output buffer
+    const float* lfoData = globalLFOData + (startSample - globalLFOStartSample);
+
+    // The cutoffs are worked out once per control interval either way
+    const int chunkSize = LadderFilterBank::controlInterval;
 
-    // Process filter in small chunks to balance performance and modulation smoothness
-    const int chunkSize = 32; // Process 32 samples at a time
-    
     for (int startPos = 0; startPos < numSamples; startPos += chunkSize)
     {
         int samplesToProcess = juce::jmin(chunkSize, numSamples - startPos);
         
-        // Get filter envelope value for this chunk (if enabled)
-        float filterEnvValue = filterADSREnabled ? filterADSR.getNextSample() : 1.0f;
-        
-        // Get average LFO value for this chunk
+        // Filter envelope value at the end of this chunk. It moves on by the whole chunk, so it
+        // keeps time with the note whatever the control rate (and while it is switched off).
+        const float filterEnvValue = filterADSR.advance(samplesToProcess);
+
+        // Get average LFO value for this chunk (the ladder's cutoff only changes per chunk)
         float avgLfoValue = 0.0f;
-        for (int i = 0; i < samplesToProcess; ++i)
+
+        if (!sampleAccurate)
         {
-            avgLfoValue += lfoData[startPos + i];
+            for (int i = 0; i < samplesToProcess; ++i)
+            {
+                avgLfoValue += lfoData[startPos + i];
+            }
+            avgLfoValue /= samplesToProcess;
         }
-        avgLfoValue /= samplesToProcess;
-        
-        // Calculate modulated cutoff frequency (only apply envelope if enabled)
-        float modulatedCutoff = filterADSREnabled ? 
-            baseCutoff + filterEnvValue * adsrFilterAmount * (20000.0f - baseCutoff) :
-            baseCutoff;
-
-        // Apply LFO modulation
-        modulatedCutoff *= (1.0f + avgLfoValue * lfoAmount * 4.0f); // Increased LFO amount for more audible effect
-
-        // Clamp to reasonable range
-        modulatedCutoff = juce::jlimit(20.0f, 20000.0f, modulatedCutoff);
 
-        // Set filter cutoff for this chunk
-        filter.setCutoffFrequencyHz(modulatedCutoff);
-        
-        // Process this chunk through the filter
-        auto chunkBlock = synthBlock.getSubBlock(startPos, samplesToProcess);
-        juce::dsp::ProcessContextReplacing<float> chunkContext(chunkBlock);
-        filter.process(chunkContext);
+        // Both filters follow the envelope and the LFO from their own base cutoff
+        for (int filter = 0; filter < numFilters; ++filter)
+        {
+            const float baseCutoff = baseCutoffs[filter];
+            const int lane = voiceBank->getFilterLane(voiceIndex, filter);
+
+            // Calculate the cutoff the envelope asks for (only apply envelope if enabled)
+            const float envelopeCutoff = filterADSREnabled ?
+                baseCutoff + filterEnvValue * adsrFilterAmount * (20000.0f - baseCutoff) :
+                baseCutoff;
+
+            if (sampleAccurate)
+            {
+                // Glide from the previous chunk's envelope value and follow the LFO sample by sample
+                auto& stateVariableFilters = voiceBank->getStateVariableFilters();
+                const float lastEnvelopeCutoff = lastEnvelopeCutoffs[filter];
+                const float envelopeStep = (envelopeCutoff - lastEnvelopeCutoff) / static_cast<float>(samplesToProcess);
+
+                for (int i = 0; i < samplesToProcess; ++i)
+                {
+                    const float cutoff = (lastEnvelopeCutoff + envelopeStep * static_cast<float>(i + 1)) * (1.0f + lfoData[startPos + i] * lfoAmount * 4.0f);
+                    stateVariableFilters.setCutoff(lane, startPos + i, juce::jlimit(20.0f, 20000.0f, cutoff));
+                }
+            }
+            else
+            {
+                // Apply LFO modulation
+                float modulatedCutoff = envelopeCutoff * (1.0f + avgLfoValue * lfoAmount * 4.0f); // Increased LFO amount for more audible effect
+
+                // Clamp to reasonable range
+                modulatedCutoff = juce::jlimit(20.0f, 20000.0f, modulatedCutoff);
+
+                // Schedule the filter cutoff for this chunk
+                voiceBank->getLadderFilters().setCutoff(lane, startPos / chunkSize, modulatedCutoff);
+            }
+
+            lastEnvelopeCutoffs[filter] = envelopeCutoff;
+        }
     }
-    // TODO until here
+}
+
+void SynthVoice::mixInto(juce::AudioBuffer<float> &outputBuffer, int startSample, int numSamples)
+{
+    if (!hasRenderedBlock)
+        return;
 
-    // Apply ADSR envelope
-    adsr.applyEnvelopeToBuffer(synthBuffer, 0, numSamples);
+    const int numOutputChannels = outputBuffer.getNumChannels();
 
-    // Add the synthesized audio to the output buffer with soft limiting
-    for (int channel = 0; channel < outputBuffer.getNumChannels(); ++channel)
+    // Pan the voice into the output buffer, limiting happens once on the master bus. A stereo
+    // voice sends its left and right channels to the first two outputs (both to a mono output).
+    for (int channel = 0; channel < numOutputChannels; ++channel)
     {
         auto* outputData = outputBuffer.getWritePointer(channel, startSample);
-        auto* synthData = synthBuffer.getReadPointer(channel);
-        
-        for (int sample = 0; sample < numSamples; ++sample)
+        const float panGain = getPanGain(channel, numOutputChannels);
+
+        if (numRenderedChannels == 1)
         {
-            float newSample = outputData[sample] + synthData[sample];
-            
-            // Soft limiting to prevent harsh clipping 
-            // TODO Use this outside of voice
-            if (newSample > 0.95f)
-                newSample = 0.95f + 0.05f * std::tanh((newSample - 0.95f) / 0.05f);
-            else if (newSample < -0.95f)
-                newSample = -0.95f + 0.05f * std::tanh((newSample + 0.95f) / 0.05f);
-                
-            outputData[sample] = newSample;
+            juce::FloatVectorOperations::addWithMultiply(outputData, scratchBlock.getChannelPointer(0), panGain, numSamples);
+        }
+        else if (numOutputChannels == 1)
+        {
+            juce::FloatVectorOperations::addWithMultiply(outputData, scratchBlock.getChannelPointer(0), 0.5f, numSamples);
+            juce::FloatVectorOperations::addWithMultiply(outputData, scratchBlock.getChannelPointer(1), 0.5f, numSamples);
+        }
+        else
+        {
+            const auto* voiceData = scratchBlock.getChannelPointer(static_cast<size_t>(juce::jmin(channel, 1)));
+            juce::FloatVectorOperations::addWithMultiply(outputData, voiceData, panGain, numSamples);
         }
     }
+}
+
+void SynthVoice::setCullingFloor(const float decibels)
+{
+    cullingFloorGain = juce::Decibels::decibelsToGain(decibels);
+}
 
-    // Clear the voice if the envelope has finished
-    if (!adsr.isActive())
-        clearCurrentNote();
+void SynthVoice::setVoiceBank(VoiceBank* bank, const int index)
+{
+    voiceBank = bank;
+    voiceIndex = index;
 }
 
-void SynthVoice::updateEnvelope(const float attack, const float decay, const float sustain, const float release)
+void SynthVoice::finishNote()
 {
-    adsr.updateEnvelope(attack, decay, sustain, release);
+    clearCurrentNote();
+    voiceBank->stopVoice(voiceIndex);
 }
 
-void SynthVoice::updateFilter(const float cutoff, const float resonance, const int mode)
+void SynthVoice::updateEnvelope(const float attack, const float decay, const float sustain, const float release, const float curve)
 {
-    baseCutoff = cutoff;
-    baseResonance = resonance;
-    filterMode = mode;
+    adsr.updateEnvelope(attack, decay, sustain, release, curve);
+}
 
-    filter.setResonance(baseResonance);
+void SynthVoice::updateFilter(const float cutoff, const float resonance, const int mode, const float morph)
+{
+    baseCutoffs[0] = cutoff;
+    baseResonances[0] = resonance;
 
-    // Map the mode parameter to LadderFilterMode
+    // Both filter types follow the settings, so switching between them doesn't jump
+    voiceBank->setVoiceResonance(voiceIndex, 0, resonance);
+    voiceBank->getStateVariableFilters().setMorph(voiceBank->getFilterLane(voiceIndex, 0), morph);
+    setFilterMode(0, mode);
+}
+
+void SynthVoice::updateSecondFilter(const float cutoff, const float resonance, const int mode)
+{
+    baseCutoffs[1] = cutoff;
+    baseResonances[1] = resonance;
+    voiceBank->setVoiceResonance(voiceIndex, 1, resonance);
+
+    // The second filter has no morph control, its state-variable filter takes the mode's response
+    constexpr float morphs[] = { StateVariableFilterBank::lowPass, StateVariableFilterBank::lowPass,
+                                 StateVariableFilterBank::highPass, StateVariableFilterBank::highPass,
+                                 StateVariableFilterBank::bandPass, StateVariableFilterBank::bandPass };
+
+    voiceBank->getStateVariableFilters().setMorph(voiceBank->getFilterLane(voiceIndex, 1), morphs[juce::jlimit(0, 5, mode)]);
+    setFilterMode(1, mode);
+}
+
+void SynthVoice::setFilterMode(const int filterIndex, const int mode)
+{
+    auto& filterBank = voiceBank->getLadderFilters();
+    const int lane = voiceBank->getFilterLane(voiceIndex, filterIndex);
+
+    // Map the mode parameter to the ladder's modes
     switch (mode)
     {
     case 0:
-        filter.setMode(juce::dsp::LadderFilterMode::LPF12);
+        filterBank.setMode(lane, LadderFilterBank::Mode::lpf12);
         break;
     case 1:
-        filter.setMode(juce::dsp::LadderFilterMode::LPF24);
+        filterBank.setMode(lane, LadderFilterBank::Mode::lpf24);
         break;
     case 2:
-        filter.setMode(juce::dsp::LadderFilterMode::HPF12);
+        filterBank.setMode(lane, LadderFilterBank::Mode::hpf12);
         break;
     case 3:
-        filter.setMode(juce::dsp::LadderFilterMode::HPF24);
+        filterBank.setMode(lane, LadderFilterBank::Mode::hpf24);
         break;
     case 4:
-        filter.setMode(juce::dsp::LadderFilterMode::BPF12);
+        filterBank.setMode(lane, LadderFilterBank::Mode::bpf12);
         break;
     case 5:
-        filter.setMode(juce::dsp::LadderFilterMode::BPF24);
+        filterBank.setMode(lane, LadderFilterBank::Mode::bpf24);
         break;
     default:
-        filter.setMode(juce::dsp::LadderFilterMode::LPF24);
+        filterBank.setMode(lane, LadderFilterBank::Mode::lpf24);
         break;
     }
 }
 
-void SynthVoice::updateFilterEnvelope(const float attack, const float decay, const float sustain, const float release, const bool enabled, const float amount)
+void SynthVoice::updateFilterEnvelope(const float attack, const float decay, const float sustain, const float release, const float curve,
+                                      const bool enabled, const float amount)
 {
-    filterADSR.updateEnvelope(attack, decay, sustain, release);
+    filterADSR.updateEnvelope(attack, decay, sustain, release, curve);
     filterADSREnabled = enabled;
     adsrFilterAmount = amount;
 }
 
-void SynthVoice::setGlobalLFOData(const float* lfoData, const float amount)
+void SynthVoice::setGlobalLFOData(const float* lfoData, const int lfoStartSample, const float amount)
 {
     globalLFOData = lfoData;
+    globalLFOStartSample = lfoStartSample;
     lfoAmount = amount;
 }
 
-void SynthVoice::updateWaveform(const int waveformType, const int oscIndex)
+void SynthVoice::setPan(const float newPan)
 {
-    currentWaveform = waveformType;
-    auto osc = (oscIndex == 1) ? &oscillator1 : (oscIndex == 2) ? &oscillator2 : &oscillator3;
-
-    switch (waveformType)
-    {
-    case 0: // Sine
-        osc->initialise([](float x)
-                              { return std::sin(x); });
-        break;
-
-    case 1: // Square
-        osc->initialise([](float x)
-                              { return x < 0.0f ? -1.0f : 1.0f; });
-        break;
-
-    case 2: // Sawtooth
-        osc->initialise([](float x)
-                              { return x / juce::MathConstants<float>::pi; });
-        break;
-
-    case 3: // Triangle
-        osc->initialise([](float x)
-                              { return 2.0f * std::abs(2.0f * (x / juce::MathConstants<float>::twoPi - std::floor(x / juce::MathConstants<float>::twoPi + 0.5f))) - 1.0f; });
-        break;
-
-    case 4: // Noise
-        osc->initialise([this](float x)
-                              { 
-                juce::ignoreUnused(x);
-                return random.nextFloat() * 2.0f - 1.0f; });
-        break;
-
-    default: // Default to sine
-        osc->initialise([](float x)
-                              { return std::sin(x); });
-        break;
-    }
+    pan = juce::jlimit(-1.0f, 1.0f, newPan);
 }
 
-void SynthVoice::setOscEnabled(const bool osc1, const bool osc2, const bool osc3)
+float SynthVoice::getPanGain(const int channel, const int numOutputChannels) const
 {
-    osc1Enabled = osc1;
-    osc2Enabled = osc2;
-    osc3Enabled = osc3; 
-}
\ No newline at end of file
+    // Mono outputs just get the voice as it is
+    if (numOutputChannels < 2)
+        return 1.0f;
+
+    // Balance law: the centre stays at unity gain so an unspread patch sounds exactly like
+    // the old per-channel rendering, and turning towards one side only attenuates the other
+    if (channel == 0)
+        return juce::jmin(1.0f, 1.0f - pan);
+    if (channel == 1)
+        return juce::jmin(1.0f, 1.0f + pan);
+
+    return 1.0f;
+}
@@ -13,6 +13,7 @@
 #include <JuceHeader.h>
 #include "SynthSound.h"
 #include "../Data/ADSRData.h"
+#include "VoiceBank.h"
 
 class SynthVoice : public juce::SynthesiserVoice
 {
@@ -26,32 +27,47 @@ public:
     void pitchWheelMoved (int newValue) override;
     void controllerMoved (int controllerNumber, int newValue) override;
     void renderNextBlock (juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples) override;
-    void updateEnvelope(const float attack, const float decay, const float sustain, const float release);
-    void updateFilter(const float cutoff, const float resonance, const int mode);
-    void updateFilterEnvelope(const float attack, const float decay, const float sustain, const float release, const bool enabled, const float amount);
+
+    // Schedules this voice's filter cutoff (envelope and LFO) for the coming block in the voice
+    // bank's filters, which filter all voices together. Has to run before the bank renders.
+    void updateFilterCutoffs(int startSample, int numSamples);
+
+    // renderNextBlock in two steps: renderVoice only touches this voice's own state, so different
+    // voices can render on different threads, mixInto then adds the result to the output
+    void renderVoice(int startSample, int numSamples);
+    void mixInto(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples);
+
+    void updateEnvelope(const float attack, const float decay, const float sustain, const float release, const float curve);
+    void updateFilter(const float cutoff, const float resonance, const int mode, const float morph);
+    void updateSecondFilter(const float cutoff, const float resonance, const int mode); // Follows the same envelope and LFO
+    void updateFilterEnvelope(const float attack, const float decay, const float sustain, const float release, const float curve,
+                              const bool enabled, const float amount);
     void updateFilterADSREnabled(const bool enabled);
-    void setGlobalLFOData(const float* lfoData, const float amount);
-    void updateWaveform(const int waveformType, const int oscIndex);
-    void setOscEnabled(const bool osc1, const bool osc2, const bool osc3);
+    void setGlobalLFOData(const float* lfoData, const int lfoStartSample, const float amount);
+    void setPan(const float newPan);
+    void setCullingFloor(const float decibels); // Released voices quieter than this are retired early
+    void setVoiceBank(VoiceBank* bank, const int index);
 
 private:
+    void finishNote();
+    void holdPeak(const float peak, const int numSamples); // Adds a block's pre-envelope peak to peakWindows
+    float getPanGain(const int channel, const int numOutputChannels) const;
+    void setFilterMode(const int filterIndex, const int mode);
+
     float freq = 440.0f; // Frequency of the note
     float volume = 1.0f; // Volume of the note
-    int currentWaveform = 0; // Current waveform type (0=Sine, 1=Square, 2=Saw, 3=Triangle, 4=Noise)
+    float pan = 0.0f; // Stereo position of the voice (-1=left, 0=centre, 1=right)
 
-    bool osc1Enabled = true; // Is oscillator 1 enabled
-    bool osc2Enabled = true; // Is oscillator 2 enabled
-    bool osc3Enabled = true; // Is oscillator 3 enabled
-    
-    // Filter parameters
-    float baseCutoff = 1000.0f; // Base cutoff frequency
-    float baseResonance = 0.1f; // Base resonance
-    int filterMode = 1; // Filter mode
+    // Filter parameters, for each of the voice's filters
+    float baseCutoffs[VoiceBank::numFilters] = { 1000.0f, 1000.0f }; // Base cutoff frequency
+    float baseResonances[VoiceBank::numFilters] = { 0.1f, 0.0f }; // Base resonance
+    float lastEnvelopeCutoffs[VoiceBank::numFilters] = { 1000.0f, 1000.0f }; // Envelope part of the cutoff at the end of the last chunk
     
     // LFO parameters
     float lfoFrequency = 2.0f;
     float lfoAmount = 0.2f; // Set a default amount that's actually audible
     const float* globalLFOData = nullptr; // Pointer to global LFO data
+    int globalLFOStartSample = 0; // Output sample that globalLFOData[0] lines up with
     
     // Filter ADSR state
     bool filterADSREnabled = true; // Default to enabled
@@ -59,13 +75,23 @@ private:
     
     ADSRData adsr; // ADSR envelope
     ADSRData filterADSR; // Filter envelope
+    bool isReleasing = false; // Has the amp envelope gone into its release stage
+    int envelopeDelay = 0; // Samples the voice bank's output still lags the note by, the envelope waits for them
+    float cullingFloorGain = juce::Decibels::decibelsToGain(-90.0f);
+    float peakWindows[2] = {}; // Pre-envelope peak of the last full window and of the one filling up
+    int peakWindowSamples = 0; // Samples in the window filling up
+    int peakWindowLength = 4410;
 
-    juce::dsp::Oscillator<float> oscillator1 { [](float x) { return std::sin(x); } }; // Oscillator - will be updated dynamically
-    juce::dsp::Oscillator<float> oscillator2 { [](float x) { return std::sin(x); } }; // LFO oscillator
-    juce::dsp::Oscillator<float> oscillator3 { [](float x) { return std::sin(x); } }; // LFO oscillator
+    // The oscillators and ladder filters of all voices live in the voice bank, this voice owns one lane of it
+    VoiceBank* voiceBank = nullptr;
+    int voiceIndex = 0;
 
-    juce::dsp::Gain<float> gain; // Gain for volume control
-    juce::dsp::LadderFilter<float> filter; // Ladder filter for sound shaping
-    
-    juce::Random random; // For noise generation
+    // Scratch memory for rendering, allocated once in prepareToPlay so that
+    // renderNextBlock never has to touch the heap
+    static constexpr size_t scratchAlignment = 64; // One cache line
+    static constexpr size_t envelopeChannel = 2; // After the voice's (up to) two channels
+    juce::HeapBlock<char> scratchMemory;
+    juce::dsp::AudioBlock<float> scratchBlock;
+    bool hasRenderedBlock = false; // Does the scratch arena hold a block that still has to be mixed
+    int numRenderedChannels = 1; // 2 while the voice bank renders spread unison
 };
@@ -0,0 +1,1210 @@
+/*
+  ==============================================================================
+
+    VoiceBank.cpp
+    Created: 17 Oct 2026 10:12:31am
+    Author:  max
+
+  ==============================================================================
+*/
+
+#include "VoiceBank.h"
+#include "AnalyticOscillator.h"
+#include "FastMath.h"
+
+namespace
+{
+    using SIMDFloat = VoiceBank::SIMDFloat;
+    using Waveform = VoiceBank::Waveform;
+
+    // Resolved at compile time, so every waveform gets its own loop with the shape inlined
+    template <Waveform waveform, int Points>
+    inline SIMDFloat analyticShape(const SIMDFloat phase, const SIMDFloat delta, const SIMDFloat inverseDelta) noexcept
+    {
+        if constexpr (waveform == Waveform::square)
+            return AnalyticOscillator::square<Points>(phase, delta, inverseDelta);
+        else if constexpr (waveform == Waveform::saw)
+            return AnalyticOscillator::saw<Points>(phase, delta, inverseDelta);
+        else if constexpr (waveform == Waveform::triangle)
+            return AnalyticOscillator::triangle<Points>(phase, delta, inverseDelta);
+        else
+            return AnalyticOscillator::sine(phase, delta, inverseDelta);
+    }
+
+    // The shapes without any band-limiting, to work out the size of the hard sync jumps
+    inline SIMDFloat naiveShape(const Waveform waveform, const SIMDFloat p) noexcept
+    {
+        switch (waveform)
+        {
+        case Waveform::square:
+        {
+            const auto firstHalf = SIMDFloat::lessThan(p, SIMDFloat::expand(0.5f));
+            return (SIMDFloat::expand(-1.0f) & firstHalf) + (SIMDFloat::expand(1.0f) & ~firstHalf);
+        }
+        case Waveform::saw:
+            return p * 2.0f - SIMDFloat::expand(1.0f);
+        case Waveform::triangle:
+            return SIMDFloat::abs(p - SIMDFloat::expand(0.5f)) * 4.0f - SIMDFloat::expand(1.0f);
+        case Waveform::sine:
+        case Waveform::noise:
+        case Waveform::pinkNoise:
+        case Waveform::brownNoise:
+        case Waveform::wavetable: // Looked up in the table instead (see renderWavetableChunk)
+        case Waveform::additive: // Summed instead (see renderAdditiveChunk)
+        default:
+            return AnalyticOscillator::sine(p, p, p);
+        }
+    }
+
+    // Jump at phase 0 that each analytic shape already corrects for itself
+    constexpr float naturalJump(const Waveform waveform) noexcept
+    {
+        return waveform == Waveform::square || waveform == Waveform::saw ? -2.0f : 0.0f;
+    }
+
+    // One sample of a hard synced oscillator. If the master wraps during the coming sample the
+    // slave restarts there: the jump is band-limited with a 2-point PolyBLEP, one side of it added
+    // to value now and the other left in pending for the next sample. shape gives the slave's
+    // values either side of the jump, ownJump is the jump at phase 0 the slave's shape corrects
+    // for by itself. Returns the slave's next phase.
+    template <typename Shape>
+    inline SIMDFloat syncStep(Shape&& shape, const float ownJump, const SIMDFloat phase, const SIMDFloat delta,
+                              const SIMDFloat masterPhase, const SIMDFloat masterDelta, const SIMDFloat inverseMasterDelta,
+                              SIMDFloat& value, SIMDFloat& pending) noexcept
+    {
+        const auto one = SIMDFloat::expand(1.0f);
+        const auto resets = SIMDFloat::greaterThanOrEqual(masterPhase + masterDelta, one);
+
+        // Fraction of the coming sample before the master wraps, and where the slave is by then
+        const auto before = SIMDFloat::min((one - masterPhase) * inverseMasterDelta, one);
+        auto phaseAtReset = SIMDFloat::multiplyAdd(phase, delta, before);
+        phaseAtReset -= SIMDFloat::truncate(phaseAtReset);
+
+        const auto jump = (shape(SIMDFloat::expand(0.0f)) - shape(phaseAtReset)) & resets;
+        value += jump * AnalyticOscillator::blepResidual<2>(SIMDFloat::expand(0.0f) - before);
+        pending = (jump - (SIMDFloat::expand(ownJump) & resets)) * AnalyticOscillator::blepResidual<2>(one - before);
+
+        auto next = phase + delta;
+        next -= SIMDFloat::truncate(next);
+        return ((delta * (one - before)) & resets) + (next & ~resets);
+    }
+
+    // Peak phase deviation of the phase modulation, in cycles
+    constexpr float maxModulationDepth = 2.0f;
+
+    // Adds the phase modulation and wraps back into 0..1 (the offset keeps the sum positive)
+    inline SIMDFloat modulatePhase(const SIMDFloat phase, const float* modulator, const SIMDFloat depth) noexcept
+    {
+        const auto p = SIMDFloat::multiplyAdd(phase + SIMDFloat::expand(8.0f), SIMDFloat::fromRawArray(modulator), depth);
+        return p - SIMDFloat::truncate(p);
+    }
+
+    // Adaptive oversampling: a voice asks for it once its filter resonance or its highest oscillator
+    // pitch (in cycles per sample, 1/32 is about 1.4 kHz at 44.1 kHz) reaches these, and an
+    // oversampled group only lets go again a little below them so it doesn't flip back and forth
+    constexpr float oversamplingResonance = 0.5f;
+    constexpr float oversamplingPitch = 1.0f / 32.0f;
+    constexpr float oversamplingHysteresis = 0.8f;
+
+    // Filters are skipped while they are low passes with no resonance and a cutoff at least this high
+    // (the top of the cutoff range, less a little LFO wobble). Going in and out of that crossfades
+    // over bypassFadeLength samples.
+    constexpr float transparentCutoff = 19000.0f;
+    constexpr int bypassFadeLength = 64;
+
+    // Start phases for the unison copies, spread by the golden ratio so they don't all
+    // line up at note on (copy 0 starts at 0 like a single oscillator)
+    inline float unisonStartPhase(const int unisonIndex) noexcept
+    {
+        const float phase = static_cast<float>(unisonIndex) * 0.618034f;
+        return phase - std::floor(phase);
+    }
+}
+
+VoiceBank::VoiceBank()
+{
+    // Builds the shared tables on first use, so that never happens on the audio thread
+    for (int osc = 0; osc < numOscillators; ++osc)
+    {
+        wavetables[osc] = &Wavetable::getBuiltIn(Wavetable::BuiltIn::sine);
+        setUnison(osc + 1, 1, 0.0f, 0.0f, 1.0f);
+
+        const float fundamental = 1.0f;
+        setAdditiveSpectrum(osc + 1, &fundamental, 1);
+    }
+}
+
+void VoiceBank::prepareToPlay(double sampleRate, int samplesPerBlock, int numVoices)
+{
+    currentSampleRate = sampleRate;
+    maxBlockSize = samplesPerBlock;
+    // The active mask has a bit per voice, shifting past it would be undefined
+    jassert(numVoices <= maxVoices);
+    const int numBankVoices = juce::jlimit(0, maxVoices, numVoices);
+    numLanes = ((numBankVoices + laneWidth - 1) / laneWidth) * laneWidth;
+
+    // One allocation for all the per-lane arrays plus the output blocks. numLanes is a multiple
+    // of the SIMD width, so every array (and every sample row of the outputs) stays aligned.
+    const auto numStateRows = 3 * numOscillators * maxUnison + maxUnison + 3 + numFilters;
+    const auto numFloats = static_cast<size_t>(numLanes) * static_cast<size_t>(numStateRows + 2 * maxBlockSize);
+    stateMemory.calloc(numFloats * sizeof(float) + stateAlignment);
+
+    auto* data = juce::snapPointerToAlignment(reinterpret_cast<float*>(stateMemory.getData()), stateAlignment);
+
+    for (int osc = 0; osc < numOscillators; ++osc)
+    {
+        phases[osc] = data;
+        data += maxUnison * numLanes;
+        phaseDeltas[osc] = data;
+        data += maxUnison * numLanes;
+        inversePhaseDeltas[osc] = data;
+        data += maxUnison * numLanes;
+    }
+
+    syncCorrections = data;
+    data += maxUnison * numLanes;
+    noteDeltas = data;
+    data += numLanes;
+    gains = data;
+    data += numLanes;
+    resonances = data;
+    data += numFilters * numLanes;
+    bypassLevels = data;
+    data += numLanes;
+
+    for (auto& output : outputs)
+    {
+        output = data;
+        data += numLanes * maxBlockSize;
+    }
+
+    activeVoiceMask.store(0);
+    noiseGenerator.prepare(numLanes);
+    cutoffTable.prepare(sampleRate);
+    ladderFilters.prepare(cutoffTable, samplesPerBlock, numFilters * numLanes);
+    stateVariableFilters.prepare(sampleRate, samplesPerBlock, numFilters * numLanes);
+    oversampler.prepare(numLanes);
+    groups.assign(static_cast<size_t>(numLanes / laneWidth), Group {});
+    mipLevels.assign(static_cast<size_t>(numOscillators * numLanes), 0);
+}
+
+void VoiceBank::startVoice(const int voiceIndex, const float frequency, const float gain)
+{
+    jassert(juce::isPositiveAndBelow(voiceIndex, numLanes));
+
+    noteDeltas[voiceIndex] = static_cast<float>(frequency / currentSampleRate);
+    gains[voiceIndex] = gain;
+
+    // Reset oscillator phases to avoid frequency sweeps
+    for (int osc = 0; osc < numOscillators; ++osc)
+    {
+        for (int u = 0; u < maxUnison; ++u)
+            phases[osc][u * numLanes + voiceIndex] = unisonStartPhase(u);
+
+        updateLaneFrequencies(osc, voiceIndex);
+    }
+
+    for (int u = 0; u < maxUnison; ++u)
+        syncCorrections[u * numLanes + voiceIndex] = 0.0f;
+
+    // Whatever the previous note left on its way through the decimation filters
+    oversampler.reset(voiceIndex);
+
+    // A new note starts out filtered, it only fades to bypassing the filters if they turn out to be open
+    bypassLevels[voiceIndex] = 0.0f;
+    activeVoiceMask.fetch_or(juce::uint64 { 1 } << voiceIndex);
+}
+
+void VoiceBank::stopVoice(const int voiceIndex)
+{
+    jassert(juce::isPositiveAndBelow(voiceIndex, numLanes));
+    activeVoiceMask.fetch_and(~(juce::uint64 { 1 } << voiceIndex));
+}
+
+void VoiceBank::updateLaneFrequencies(const int oscIndex, const int lane)
+{
+    const auto& settings = getUnison(oscIndex);
+    const float noteDelta = noteDeltas[lane] * pitchRatios[oscIndex];
+
+    for (int u = 0; u < settings.numVoices; ++u)
+    {
+        const float delta = noteDelta * settings.ratios[u];
+        phaseDeltas[oscIndex][u * numLanes + lane] = delta;
+        inversePhaseDeltas[oscIndex][u * numLanes + lane] = delta > 0.0f ? 1.0f / delta : 0.0f;
+    }
+
+    // One mip level for all copies, picked for the highest one so none of them aliases
+    mipLevels[static_cast<size_t>(oscIndex * numLanes + lane)] = Wavetable::getLevelForPhaseDelta(noteDelta * settings.maxRatio);
+}
+
+void VoiceBank::updateWaveform(const Waveform waveform, const int oscIndex)
+{
+    jassert(oscIndex >= 1 && oscIndex <= numOscillators);
+    waveforms[oscIndex - 1] = waveform;
+
+    // Everything but noise and additive plays from a wavetable, the built-in ones are in the order of the first choices
+    if (waveform == Waveform::wavetable)
+        wavetables[oscIndex - 1] = userWavetables[oscIndex - 1] != nullptr ? userWavetables[oscIndex - 1] : &Wavetable::getBuiltIn(Wavetable::BuiltIn::sine);
+    else if (waveform == Waveform::sine || waveform == Waveform::square || waveform == Waveform::saw || waveform == Waveform::triangle)
+        wavetables[oscIndex - 1] = &Wavetable::getBuiltIn(static_cast<Wavetable::BuiltIn>(waveform));
+}
+
+void VoiceBank::setUserWavetable(const int oscIndex, const Wavetable* table)
+{
+    jassert(oscIndex >= 1 && oscIndex <= numOscillators);
+    userWavetables[oscIndex - 1] = table;
+
+    if (waveforms[oscIndex - 1] == Waveform::wavetable)
+        updateWaveform(Waveform::wavetable, oscIndex);
+}
+
+void VoiceBank::setWavetablePositions(const int oscIndex, const float* positions, const int firstSample)
+{
+    jassert(oscIndex >= 1 && oscIndex <= numOscillators);
+    wavetablePositions[oscIndex - 1] = positions;
+    wavetablePositionStarts[oscIndex - 1] = firstSample;
+}
+
+void VoiceBank::setAdditiveSpectrum(const int oscIndex, const float* amplitudes, const int numPartials)
+{
+    jassert(oscIndex >= 1 && oscIndex <= numOscillators);
+    auto& numStored = numAdditivePartials[oscIndex - 1];
+    numStored = juce::jlimit(0, maxPartials, numPartials);
+
+    // Trailing silent partials would only cost time
+    while (numStored > 0 && amplitudes[numStored - 1] == 0.0f)
+        --numStored;
+
+    std::copy(amplitudes, amplitudes + numStored, additiveSpectra[oscIndex - 1]);
+}
+
+void VoiceBank::setUnison(const int oscIndex, const int numVoices, const float detuneCents, const float spread, const float blend)
+{
+    jassert(oscIndex >= 1 && oscIndex <= numOscillators);
+    auto& settings = unison[oscIndex - 1];
+    const int newNumVoices = juce::jlimit(1, maxUnison, numVoices);
+
+    // ratios[0] is only 0 before the first call
+    if (settings.ratios[0] != 0.0f && newNumVoices == settings.numVoices && detuneCents == settings.detuneCents
+        && spread == settings.spread && blend == settings.blend)
+        return;
+
+    settings.numVoices = newNumVoices;
+    settings.detuneCents = detuneCents;
+    settings.spread = spread;
+    settings.blend = blend;
+
+    float levels[maxUnison] = {};
+    float sumOfSquares = 0.0f;
+
+    for (int u = 0; u < newNumVoices; ++u)
+    {
+        // Position of this copy from -1 (lowest, leftmost) to 1 (highest, rightmost)
+        const float offset = newNumVoices > 1 ? 2.0f * static_cast<float>(u) / static_cast<float>(newNumVoices - 1) - 1.0f : 0.0f;
+        const bool isCentre = newNumVoices <= 2 || std::abs(offset) <= 1.0f / static_cast<float>(newNumVoices - 1) + 1.0e-4f;
+
+        settings.ratios[u] = std::exp2(offset * detuneCents / 1200.0f);
+        levels[u] = isCentre ? 1.0f : blend;
+        sumOfSquares += levels[u] * levels[u];
+
+        // Equal power pan, scaled so a centred copy has unity gain on both sides
+        const float angle = (offset * spread + 1.0f) * juce::MathConstants<float>::pi * 0.25f;
+        settings.leftGains[u] = std::cos(angle) * juce::MathConstants<float>::sqrt2;
+        settings.rightGains[u] = std::sin(angle) * juce::MathConstants<float>::sqrt2;
+    }
+
+    const float normalise = 1.0f / std::sqrt(sumOfSquares);
+
+    for (int u = 0; u < newNumVoices; ++u)
+    {
+        settings.leftGains[u] *= levels[u] * normalise;
+        settings.rightGains[u] *= levels[u] * normalise;
+    }
+
+    settings.maxRatio = std::exp2(std::abs(detuneCents) / 1200.0f);
+
+    // Voices that are already playing follow the new detune straight away (and so does a
+    // modulating oscillator 2, which uses oscillator 1's unison)
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        updateLaneFrequencies(oscIndex - 1, lane);
+
+        if (oscIndex == 1 && oscModulation != Modulation::mix)
+            updateLaneFrequencies(1, lane);
+    }
+}
+
+void VoiceBank::setOscPitch(const int oscIndex, const float semitones)
+{
+    jassert(oscIndex >= 1 && oscIndex <= numOscillators);
+    const float ratio = std::exp2(semitones / 12.0f);
+
+    if (ratio == pitchRatios[oscIndex - 1])
+        return;
+
+    pitchRatios[oscIndex - 1] = ratio;
+
+    for (int lane = 0; lane < numLanes; ++lane)
+        updateLaneFrequencies(oscIndex - 1, lane);
+}
+
+void VoiceBank::setModulation(const Modulation newModulation, const float amount)
+{
+    modulationAmount = juce::jlimit(0.0f, 1.0f, amount);
+
+    if (newModulation == oscModulation)
+        return;
+
+    // Oscillator 2 switches between its own unison and oscillator 1's
+    const bool unisonChanges = (newModulation == Modulation::mix) != (oscModulation == Modulation::mix);
+    oscModulation = newModulation;
+
+    if (unisonChanges)
+        for (int lane = 0; lane < numLanes; ++lane)
+            updateLaneFrequencies(1, lane);
+}
+
+void VoiceBank::setOscillatorMode(const OscillatorMode newMode)
+{
+    oscillatorMode = newMode;
+}
+
+void VoiceBank::setFilterType(const FilterType newType)
+{
+    if (newType == filterType)
+        return;
+
+    // The new filters haven't run for a while, so whatever is left in them would pop
+    for (int lane = 0; lane < numFilters * numLanes; ++lane)
+    {
+        if (newType == FilterType::stateVariable)
+            stateVariableFilters.reset(lane);
+        else
+            ladderFilters.reset(lane);
+    }
+
+    filterType = newType;
+}
+
+void VoiceBank::setFilterRouting(const FilterRouting newRouting)
+{
+    if (newRouting == filterRouting)
+        return;
+
+    // Same as switching type: the second filters may hold what they had when they were last heard
+    if (filterRouting == FilterRouting::off)
+    {
+        for (int lane = numLanes; lane < numFilters * numLanes; ++lane)
+        {
+            ladderFilters.reset(lane);
+            stateVariableFilters.reset(lane);
+        }
+    }
+
+    filterRouting = newRouting;
+}
+
+void VoiceBank::setVoiceResonance(const int voiceIndex, const int filterIndex, const float resonance)
+{
+    jassert(juce::isPositiveAndBelow(voiceIndex, numLanes) && juce::isPositiveAndBelow(filterIndex, numFilters));
+    const int lane = getFilterLane(voiceIndex, filterIndex);
+    resonances[lane] = resonance;
+    ladderFilters.setResonance(lane, resonance);
+    stateVariableFilters.setResonance(lane, resonance);
+}
+
+void VoiceBank::setOversampling(const int factor)
+{
+    jassert(factor == 1 || factor == 2 || factor == VoiceOversampler::maxFactor);
+
+    if (factor == oversampling)
+        return;
+
+    // Between 2x and 4x the groups crossfade over by themselves, but what was on its way through
+    // the decimation filters when they are switched on or off is stale
+    if ((factor > 1) != (oversampling > 1))
+        oversampler.reset();
+
+    oversampling = factor;
+}
+
+void VoiceBank::setOscEnabled(const bool osc1, const bool osc2, const bool osc3)
+{
+    oscEnabled[0] = osc1;
+    oscEnabled[1] = osc2;
+    oscEnabled[2] = osc3;
+}
+
+bool VoiceBank::isGroupActive(const int group) const noexcept
+{
+    constexpr auto groupBits = (juce::uint64 { 1 } << laneWidth) - 1;
+    return ((activeVoiceMask.load() >> (group * laneWidth)) & groupBits) != 0;
+}
+
+bool VoiceBank::wantsOversampling(const int firstLane, const bool engaged) const
+{
+    const float margin = engaged ? oversamplingHysteresis : 1.0f;
+    const auto mask = activeVoiceMask.load();
+
+    for (int lane = firstLane; lane < firstLane + laneWidth; ++lane)
+    {
+        if (((mask >> lane) & 1) == 0)
+            continue;
+
+        if (resonances[lane] >= oversamplingResonance * margin
+            || (filterRouting != FilterRouting::off && resonances[numLanes + lane] >= oversamplingResonance * margin))
+            return true;
+
+        // Noise has no pitch to alias
+        for (int osc = 0; osc < numOscillators; ++osc)
+            if (oscEnabled[osc] && !isNoise(waveforms[osc])
+                && noteDeltas[lane] * pitchRatios[osc] * getUnison(osc).maxRatio >= oversamplingPitch * margin)
+                return true;
+    }
+
+    return false;
+}
+
+// Scales the phase increments of a group (and their inverses the other way) for rendering at another
+// rate. Only ever by powers of two, which is exact, so scaling back restores them bit for bit.
+void VoiceBank::scalePhaseDeltas(const int firstLane, const float scale)
+{
+    for (int osc = 0; osc < numOscillators; ++osc)
+    {
+        for (int u = 0; u < maxUnison; ++u)
+        {
+            const int row = u * numLanes + firstLane;
+            (SIMDFloat::fromRawArray(phaseDeltas[osc] + row) * scale).copyToRawArray(phaseDeltas[osc] + row);
+            (SIMDFloat::fromRawArray(inversePhaseDeltas[osc] + row) * (1.0f / scale)).copyToRawArray(inversePhaseDeltas[osc] + row);
+        }
+    }
+}
+
+void VoiceBank::render(const int startSample, const int numSamples)
+{
+    beginBlock(startSample, numSamples);
+
+    for (int group = 0; group < getNumGroups(); ++group)
+        renderGroup(group);
+}
+
+void VoiceBank::beginBlock(const int startSample, const int numSamples)
+{
+    jassert(numSamples <= maxBlockSize);
+
+    // Oscillator 2 only modulates when both it and oscillator 1 are on, and it isn't heard
+    // on its own in any of the modulation modes
+    blockModulating = oscModulation != Modulation::mix && oscEnabled[0] && oscEnabled[1];
+    blockHeard[0] = oscEnabled[0];
+    blockHeard[1] = oscEnabled[1] && oscModulation == Modulation::mix;
+    blockHeard[2] = oscEnabled[2];
+
+    blockNumRows = 0;
+    const bool wasStereo = stereoOutput;
+    stereoOutput = false;
+
+    for (int osc = 0; osc < numOscillators; ++osc)
+    {
+        if (!blockHeard[osc])
+            continue;
+
+        // Noise ignores unison, so it is always mono
+        blockNumRows = juce::jmax(blockNumRows, getNumRows(osc));
+        stereoOutput = stereoOutput || (getNumRows(osc) > 1 && getUnison(osc).spread != 0.0f);
+    }
+
+    blockStartSample = startSample;
+    blockNumSamples = numSamples;
+
+    // The right channel takes over the left one's way through the decimation filters
+    if (stereoOutput && !wasStereo)
+        oversampler.copyLeftToRight();
+}
+
+// With nothing heard (blockNumRows is 0) the chunks stay silent, but the filters still ring out on them
+void VoiceBank::renderGroup(const int group)
+{
+    jassert(juce::isPositiveAndBelow(group, getNumGroups()));
+
+    if (!isGroupActive(group))
+        return;
+
+    const int firstLane = group * laneWidth;
+    const int numSamples = blockNumSamples;
+    const int numChannels = stereoOutput ? 2 : 1;
+    auto& groupState = getGroup(firstLane);
+
+    // An oversampled group renders factor samples per output sample, its oscillators taking steps
+    // that much smaller, and each chunk covers that many fewer output samples
+    const int factor = oversampling > 1 ? oversampler.beginBlock(firstLane, wantsOversampling(firstLane, oversampler.getFactor(firstLane) > 1) ? oversampling : 1)
+                                        : 1;
+    const int oversamplingShift = juce::findHighestSetBit(static_cast<juce::uint32>(factor));
+    groupState.oversamplingShift = oversamplingShift;
+    for (int filter = 0; filter < numFilters; ++filter)
+    {
+        ladderFilters.setOversampling(filter * numLanes + firstLane, factor);
+        stateVariableFilters.setOversampling(filter * numLanes + firstLane, factor);
+    }
+
+    if (factor > 1)
+        scalePhaseDeltas(firstLane, 1.0f / static_cast<float>(factor));
+
+    alignas(stateAlignment) float modulator[chunkSize * laneWidth];
+    alignas(stateAlignment) float values[chunkSize * laneWidth];
+    alignas(stateAlignment) float oversampled[2][chunkSize * laneWidth];
+
+    // Decided for the whole block, so a cutoff that moves anywhere in it keeps the filters running
+    const bool transparent = areFiltersTransparent(firstLane, numSamples);
+
+    // A single pass over the block: each chunk gets all the copies of all the oscillators
+    // mixed in and is filtered before moving on, so the output rows are only brought into cache once
+    for (int start = 0; start < numSamples; start += chunkSize >> oversamplingShift)
+    {
+        const int outputLength = juce::jmin(chunkSize >> oversamplingShift, numSamples - start);
+        const int chunkLength = outputLength << oversamplingShift;
+        groupState.chunkStartSample = blockStartSample + start;
+
+        // Every oscillator and unison copy adds into the chunk: right in the output rows of this
+        // group, or with oversampling on into a buffer the oversampler decimates from
+        float* outputLeft = outputs[0] + start * numLanes + firstLane;
+        float* outputRight = stereoOutput ? outputs[1] + start * numLanes + firstLane : nullptr;
+        float* left = oversampling > 1 ? oversampled[0] : outputLeft;
+        float* right = oversampling > 1 && stereoOutput ? oversampled[1] : outputRight;
+        const int stride = oversampling > 1 ? laneWidth : numLanes;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int sample = 0; sample < chunkLength; ++sample)
+                SIMDFloat::expand(0.0f).copyToRawArray((channel == 0 ? left : right) + sample * stride);
+
+        for (int u = 0; u < blockNumRows; ++u)
+        {
+            for (int osc = 0; osc < numOscillators; ++osc)
+            {
+                if (!blockHeard[osc] || u >= getNumRows(osc))
+                    continue;
+
+                if (osc == 0 && blockModulating)
+                    renderModulatedChunk(u, firstLane, chunkLength, modulator, values);
+                else
+                    renderOscillatorChunk(osc, u, firstLane, chunkLength, Modulation::mix, nullptr, values);
+
+                mixChunk(osc, u, firstLane, chunkLength, values, left, right, stride);
+            }
+        }
+
+        filterChunk(firstLane, start, transparent, left, right, stride, chunkLength);
+
+        if (oversampling > 1)
+            oversampler.process(firstLane, left, right, outputLeft, outputRight, numLanes, outputLength);
+    }
+
+    if (factor > 1)
+        scalePhaseDeltas(firstLane, static_cast<float>(factor));
+}
+
+// Filters are skipped if every active voice's ones would hardly change the block (see the
+// filter banks' isTransparent)
+bool VoiceBank::areFiltersTransparent(const int firstLane, const int numSamples) const
+{
+    const int numActiveFilters = filterRouting == FilterRouting::off ? 1 : numFilters;
+    const int numIntervals = (numSamples + chunkSize - 1) / chunkSize;
+    const auto mask = activeVoiceMask.load();
+
+    for (int lane = firstLane; lane < firstLane + laneWidth; ++lane)
+    {
+        if (((mask >> lane) & 1) == 0)
+            continue;
+
+        for (int filter = 0; filter < numActiveFilters; ++filter)
+        {
+            const int filterLane = getFilterLane(lane, filter);
+            const bool transparent = filterType == FilterType::stateVariable
+                                         ? stateVariableFilters.isTransparent(filterLane, 0, numSamples, transparentCutoff)
+                                         : ladderFilters.isTransparent(filterLane, numIntervals, transparentCutoff);
+
+            if (!transparent)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+// What skipped filters leave of the signal: the ladder keeps its passband level, in series twice
+float VoiceBank::getBypassGain() const noexcept
+{
+    if (filterType == FilterType::stateVariable)
+        return 1.0f;
+
+    const float gain = LadderFilterBank::getTransparentGain();
+    return filterRouting == FilterRouting::serial ? gain * gain : gain;
+}
+
+// startSample is the chunk's first output sample, numSamples are at the group's rate. transparent
+// says whether the group's filters can be skipped for the block.
+void VoiceBank::filterChunk(const int firstLane, const int startSample, const bool transparent, float* left, float* right, const int stride, const int numSamples)
+{
+    bool& filtersSkipped = getGroup(firstLane).filtersSkipped;
+    const int numChannels = right != nullptr ? 2 : 1;
+    float* channels[2] = { left, right };
+    const auto gain = SIMDFloat::expand(getBypassGain());
+    auto levels = SIMDFloat::fromRawArray(bypassLevels + firstLane);
+
+    // All voices past the crossfade: only the filters' level is left to apply
+    const bool bypassed = levels == SIMDFloat::expand(1.0f);
+
+    if (transparent && bypassed)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int sample = 0; sample < numSamples; ++sample)
+                (SIMDFloat::fromRawArray(channels[channel] + sample * stride) * gain).copyToRawArray(channels[channel] + sample * stride);
+
+        filtersSkipped = true;
+        return;
+    }
+
+    // The filters of the voices that were skipped haven't seen the signal since, so they start over
+    // (a voice that started a note meanwhile has just been reset anyway)
+    if (filtersSkipped)
+    {
+        for (int lane = firstLane; lane < firstLane + laneWidth; ++lane)
+        {
+            for (int filter = 0; filter < numFilters; ++filter)
+            {
+                ladderFilters.reset(getFilterLane(lane, filter));
+                stateVariableFilters.reset(getFilterLane(lane, filter));
+            }
+        }
+
+        filtersSkipped = false;
+    }
+
+    if (!transparent && levels == SIMDFloat::expand(0.0f))
+    {
+        runFilters(firstLane, startSample, left, right, stride, numSamples);
+        return;
+    }
+
+    // Crossfading: the filters run, and the dry chunk at their level fades in against them or out
+    alignas(stateAlignment) float dry[2][chunkSize * laneWidth];
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        for (int sample = 0; sample < numSamples; ++sample)
+            (SIMDFloat::fromRawArray(channels[channel] + sample * stride) * gain).copyToRawArray(dry[channel] + sample * laneWidth);
+
+    runFilters(firstLane, startSample, left, right, stride, numSamples);
+
+    const auto target = SIMDFloat::expand(transparent ? 1.0f : 0.0f);
+    constexpr float fadeStep = 1.0f / static_cast<float>(bypassFadeLength);
+    const auto step = SIMDFloat::expand(transparent ? fadeStep : -fadeStep);
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        levels = transparent ? SIMDFloat::min(levels + step, target) : SIMDFloat::max(levels + step, target);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            float* io = channels[channel] + sample * stride;
+            const auto filtered = SIMDFloat::fromRawArray(io);
+            const auto dryValue = SIMDFloat::fromRawArray(dry[channel] + sample * laneWidth);
+            SIMDFloat::multiplyAdd(filtered, dryValue - filtered, levels).copyToRawArray(io);
+        }
+    }
+
+    levels.copyToRawArray(bypassLevels + firstLane);
+}
+
+void VoiceBank::runFilters(const int firstLane, const int startSample, float* left, float* right, const int stride, const int numSamples)
+{
+    const int interval = startSample / chunkSize;
+
+    if (filterRouting == FilterRouting::off)
+    {
+        if (filterType == FilterType::stateVariable)
+            stateVariableFilters.process(firstLane, startSample, left, right, stride, numSamples);
+        else
+            ladderFilters.process(firstLane, interval, left, right, stride, numSamples);
+
+        return;
+    }
+
+    // Both of the voices' filters in one pass
+    const int secondLane = numLanes + firstLane;
+    const bool serial = filterRouting == FilterRouting::serial;
+
+    if (filterType == FilterType::stateVariable)
+        stateVariableFilters.processPair(firstLane, secondLane, startSample, serial, left, right, stride, numSamples);
+    else
+        ladderFilters.processPair(firstLane, secondLane, interval, serial, left, right, stride, numSamples);
+}
+
+void VoiceBank::renderModulatedChunk(const int unisonIndex, const int firstLane, const int numSamples, float* modulator, float* dest)
+{
+    const int numValues = numSamples * laneWidth;
+
+    switch (oscModulation)
+    {
+    case Modulation::phase:
+        renderOscillatorChunk(1, unisonIndex, firstLane, numSamples, Modulation::mix, nullptr, modulator);
+        renderOscillatorChunk(0, unisonIndex, firstLane, numSamples, Modulation::phase, modulator, dest);
+        break;
+    case Modulation::ring:
+        // Crossfades from the dry oscillator 1 to the ring modulated one: dest * (1 - amount + amount * modulator)
+        renderOscillatorChunk(1, unisonIndex, firstLane, numSamples, Modulation::mix, nullptr, modulator);
+        renderOscillatorChunk(0, unisonIndex, firstLane, numSamples, Modulation::mix, nullptr, dest);
+        juce::FloatVectorOperations::multiply(modulator, modulationAmount, numValues);
+        juce::FloatVectorOperations::add(modulator, 1.0f - modulationAmount, numValues);
+        juce::FloatVectorOperations::multiply(dest, modulator, numValues);
+        break;
+    case Modulation::sync:
+        advancePhases(1, unisonIndex, firstLane, numSamples, modulator);
+        renderOscillatorChunk(0, unisonIndex, firstLane, numSamples, Modulation::sync, modulator, dest);
+        break;
+    case Modulation::mix:
+    default:
+        renderOscillatorChunk(0, unisonIndex, firstLane, numSamples, Modulation::mix, nullptr, dest);
+        break;
+    }
+}
+
+void VoiceBank::renderOscillatorChunk(const int oscIndex, const int unisonIndex, const int firstLane, const int numSamples,
+                                      const Modulation modulation, const float* modulator, float* dest)
+{
+    const auto oversamplingFactor = static_cast<float>(1 << getGroup(firstLane).oversamplingShift);
+
+    switch (waveforms[oscIndex])
+    {
+    case Waveform::noise:
+        noiseGenerator.render(NoiseGenerator::Colour::white, firstLane, dest, laneWidth, numSamples);
+
+        // Oversampled white noise spreads its power over a band factor times wider, most of which
+        // the decimation takes out again. Pink comes out at the same level.
+        if (oversamplingFactor > 1.0f)
+            juce::FloatVectorOperations::multiply(dest, std::sqrt(oversamplingFactor), numSamples * laneWidth);
+        return;
+    case Waveform::pinkNoise:
+        noiseGenerator.render(NoiseGenerator::Colour::pink, firstLane, dest, laneWidth, numSamples);
+        return;
+    case Waveform::brownNoise:
+        noiseGenerator.render(NoiseGenerator::Colour::brown, firstLane, dest, laneWidth, numSamples);
+
+        // Brown is the other way round: its integrator sums factor times as many steps per output sample
+        if (oversamplingFactor > 1.0f)
+            juce::FloatVectorOperations::multiply(dest, 1.0f / std::sqrt(oversamplingFactor), numSamples * laneWidth);
+        return;
+    case Waveform::sine:
+    case Waveform::square:
+    case Waveform::saw:
+    case Waveform::triangle:
+    case Waveform::wavetable:
+    case Waveform::additive:
+    default:
+        break;
+    }
+
+    // Pick the kernel once per chunk, the sample loops themselves have nothing left to dispatch on
+    switch (modulation)
+    {
+    case Modulation::phase:
+        renderShapeChunk<Modulation::phase>(oscIndex, unisonIndex, firstLane, numSamples, modulator, dest);
+        break;
+    case Modulation::sync:
+        renderShapeChunk<Modulation::sync>(oscIndex, unisonIndex, firstLane, numSamples, modulator, dest);
+        break;
+    case Modulation::mix:
+    case Modulation::ring: // Applied to the output of the kernel
+    default:
+        renderShapeChunk<Modulation::mix>(oscIndex, unisonIndex, firstLane, numSamples, modulator, dest);
+        break;
+    }
+}
+
+template <VoiceBank::Modulation modulationType>
+void VoiceBank::renderShapeChunk(const int oscIndex, const int unisonIndex, const int firstLane, const int numSamples, const float* modulator, float* dest)
+{
+    // Additive and loaded tables sound the same in every mode
+    if (waveforms[oscIndex] == Waveform::additive)
+    {
+        renderAdditiveChunk<modulationType>(oscIndex, unisonIndex, firstLane, numSamples, modulator, dest);
+        return;
+    }
+
+    // A loaded table has no analytic shape, it plays from its mip levels. It only morphs if it
+    // has frames to morph between and something sets the position.
+    if (waveforms[oscIndex] == Waveform::wavetable)
+    {
+        if (wavetables[oscIndex]->getNumFrames() > 1 && wavetablePositions[oscIndex] != nullptr)
+            renderWavetableChunk<modulationType, true>(oscIndex, unisonIndex, firstLane, numSamples, modulator, dest);
+        else
+            renderWavetableChunk<modulationType, false>(oscIndex, unisonIndex, firstLane, numSamples, modulator, dest);
+
+        return;
+    }
+
+    switch (oscillatorMode)
+    {
+    case OscillatorMode::polyBlep:
+        renderAnalyticChunk<2, modulationType>(oscIndex, unisonIndex, firstLane, numSamples, modulator, dest);
+        break;
+    case OscillatorMode::polyBlep4Point:
+        renderAnalyticChunk<4, modulationType>(oscIndex, unisonIndex, firstLane, numSamples, modulator, dest);
+        break;
+    case OscillatorMode::wavetable:
+    default:
+        renderWavetableChunk<modulationType, false>(oscIndex, unisonIndex, firstLane, numSamples, modulator, dest);
+        break;
+    }
+}
+
+template <VoiceBank::Modulation modulationType, bool morphing>
+void VoiceBank::renderWavetableChunk(const int oscIndex, const int unisonIndex, const int firstLane, const int numSamples, const float* modulator, float* dest)
+{
+    const int row = unisonIndex * numLanes + firstLane;
+
+    // Each lane reads from the mip level that suits its pitch, so the table lookups are done
+    // lane by lane while the phases are still advanced a whole register at a time
+    const float* levels[laneWidth];
+
+    for (int lane = 0; lane < laneWidth; ++lane)
+        levels[lane] = wavetables[oscIndex]->getLevel(mipLevels[static_cast<size_t>(oscIndex * numLanes + firstLane + lane)]);
+
+    alignas(stateAlignment) float lanePhases[laneWidth];
+    alignas(stateAlignment) float laneValues[laneWidth];
+    alignas(stateAlignment) float nextFrameValues[laneWidth];
+
+    auto phase = SIMDFloat::fromRawArray(phases[oscIndex] + row);
+    const auto delta = SIMDFloat::fromRawArray(phaseDeltas[oscIndex] + row);
+    const auto depth = SIMDFloat::expand(modulationAmount * maxModulationDepth);
+
+    // Only used for morphing: the position of every sample of the chunk, and the last frame
+    // that can be the lower of the two played (so the upper one always exists)
+    const auto& group = getGroup(firstLane);
+    const int oversamplingShift = group.oversamplingShift;
+    const float* positions = morphing ? wavetablePositions[oscIndex] + (group.chunkStartSample - wavetablePositionStarts[oscIndex]) : nullptr;
+    const auto lastFrame = static_cast<float>(wavetables[oscIndex]->getNumFrames() - 1);
+    const int lastLowerFrame = wavetables[oscIndex]->getNumFrames() - 2;
+    size_t frameOffset = 0;
+
+    // Only used for hard sync, where oscillator 2 is the master
+    const auto masterDelta = SIMDFloat::fromRawArray(phaseDeltas[1] + row);
+    const auto inverseMasterDelta = SIMDFloat::fromRawArray(inversePhaseDeltas[1] + row);
+    auto pending = SIMDFloat::fromRawArray(syncCorrections + row);
+
+    for (int sample = 0; sample < numSamples; ++sample, dest += laneWidth)
+    {
+        if constexpr (modulationType == Modulation::phase)
+            modulatePhase(phase, modulator + sample * laneWidth, depth).copyToRawArray(lanePhases);
+        else
+            phase.copyToRawArray(lanePhases);
+
+        SIMDFloat value;
+
+        if constexpr (morphing)
+        {
+            // The two frames either side of the position, read at every lane's own mip level and
+            // crossfaded a whole register at a time. Clamping (rather than testing) keeps the last
+            // frame reachable with a fraction of 1.
+            const float framePosition = juce::jlimit(0.0f, 1.0f, positions[sample >> oversamplingShift]) * lastFrame;
+            const int frame = juce::jmin(static_cast<int>(framePosition), lastLowerFrame);
+            const auto frameFraction = SIMDFloat::expand(framePosition - static_cast<float>(frame));
+            frameOffset = static_cast<size_t>(frame) * Wavetable::frameSize;
+
+            for (int lane = 0; lane < laneWidth; ++lane)
+            {
+                const float* level = levels[lane] + frameOffset;
+                laneValues[lane] = Wavetable::lookup(level, lanePhases[lane]);
+                nextFrameValues[lane] = Wavetable::lookup(level + Wavetable::frameSize, lanePhases[lane]);
+            }
+
+            const auto current = SIMDFloat::fromRawArray(laneValues);
+            value = SIMDFloat::multiplyAdd(current, SIMDFloat::fromRawArray(nextFrameValues) - current, frameFraction);
+        }
+        else
+        {
+            for (int lane = 0; lane < laneWidth; ++lane)
+                laneValues[lane] = Wavetable::lookup(levels[lane], lanePhases[lane]);
+
+            value = SIMDFloat::fromRawArray(laneValues);
+        }
+
+        if constexpr (modulationType == Modulation::sync)
+        {
+            value += pending;
+            const auto masterPhase = SIMDFloat::fromRawArray(modulator + sample * laneWidth);
+
+            if (waveforms[oscIndex] == Waveform::wavetable)
+            {
+                // A loaded cycle is continuous at phase 0, so the jump is read from its own table
+                // (from the lower frame while morphing)
+                phase = syncStep([&levels, frameOffset] (const SIMDFloat p)
+                                 {
+                                     alignas(stateAlignment) float lanes[laneWidth];
+                                     p.copyToRawArray(lanes);
+
+                                     for (int lane = 0; lane < laneWidth; ++lane)
+                                         lanes[lane] = Wavetable::lookup(levels[lane] + frameOffset, lanes[lane]);
+
+                                     return SIMDFloat::fromRawArray(lanes);
+                                 },
+                                 0.0f, phase, delta, masterPhase, masterDelta, inverseMasterDelta, value, pending);
+            }
+            else
+            {
+                // The built-in tables already smooth the jump at phase 0, much like the analytic shapes do
+                const auto waveform = waveforms[oscIndex];
+                phase = syncStep([waveform] (const SIMDFloat p) { return naiveShape(waveform, p); },
+                                 naturalJump(waveform), phase, delta, masterPhase, masterDelta, inverseMasterDelta, value, pending);
+            }
+        }
+        else
+        {
+            // Advance and wrap back into 0..1 (the phase is never negative, so truncating is flooring)
+            phase += delta;
+            phase -= SIMDFloat::truncate(phase);
+        }
+
+        value.copyToRawArray(dest);
+    }
+
+    phase.copyToRawArray(phases[oscIndex] + row);
+
+    if constexpr (modulationType == Modulation::sync)
+        pending.copyToRawArray(syncCorrections + row);
+}
+
+template <VoiceBank::Modulation modulationType>
+void VoiceBank::renderAdditiveChunk(const int oscIndex, const int unisonIndex, const int firstLane, const int numSamples, const float* modulator, float* dest)
+{
+    const int row = unisonIndex * numLanes + firstLane;
+    const float* amplitudes = additiveSpectra[oscIndex];
+
+    auto phase = SIMDFloat::fromRawArray(phases[oscIndex] + row);
+    const auto delta = SIMDFloat::fromRawArray(phaseDeltas[oscIndex] + row);
+    const auto depth = SIMDFloat::expand(modulationAmount * maxModulationDepth);
+
+    // Partial k is culled once k * delta reaches 0.5. Up to the lowest count any lane plays every
+    // partial is added unmasked, from there to the highest count each one is masked lane by lane.
+    // Lanes that never played (a delta of 0) don't hold the others back.
+    const auto nyquistPartial = SIMDFloat::fromRawArray(inversePhaseDeltas[oscIndex] + row) * 0.5f;
+    alignas(stateAlignment) float laneLimits[laneWidth];
+    nyquistPartial.copyToRawArray(laneLimits);
+
+    int numCommon = numAdditivePartials[oscIndex];
+    int numAny = 0;
+
+    for (const float limit : laneLimits)
+    {
+        if (limit <= 0.0f)
+            continue;
+
+        const int audible = juce::jmin(numAdditivePartials[oscIndex], static_cast<int>(std::ceil(limit)) - 1);
+        numCommon = juce::jmin(numCommon, audible);
+        numAny = juce::jmax(numAny, audible);
+    }
+
+    numCommon = juce::jmin(numCommon, numAny);
+
+    // Sum of the partials at phase p. sin and cos of the fundamental are computed once, every
+    // further partial is the previous one rotated by them (a complex multiply instead of a sin).
+    auto sumPartials = [amplitudes, numCommon, numAny, nyquistPartial] (const SIMDFloat p)
+    {
+        const auto t = p - SIMDFloat::expand(0.5f);
+        const auto sin1 = FastMath::sin2pi(t);
+        const auto cos1 = FastMath::sin2pi(SIMDFloat::expand(0.25f) - SIMDFloat::abs(t));
+
+        auto sinK = sin1, cosK = cos1;
+        auto sum = SIMDFloat::expand(0.0f);
+        int k = 1;
+
+        for (; k <= numCommon; ++k)
+        {
+            sum = SIMDFloat::multiplyAdd(sum, sinK, SIMDFloat::expand(amplitudes[k - 1]));
+
+            const auto nextSin = sinK * cos1 + cosK * sin1;
+            cosK = cosK * cos1 - sinK * sin1;
+            sinK = nextSin;
+        }
+
+        for (; k <= numAny; ++k)
+        {
+            const auto audible = SIMDFloat::lessThan(SIMDFloat::expand(static_cast<float>(k)), nyquistPartial);
+            sum = SIMDFloat::multiplyAdd(sum, sinK & audible, SIMDFloat::expand(amplitudes[k - 1]));
+
+            const auto nextSin = sinK * cos1 + cosK * sin1;
+            cosK = cosK * cos1 - sinK * sin1;
+            sinK = nextSin;
+        }
+
+        return sum;
+    };
+
+    // Only used for hard sync, where oscillator 2 is the master
+    const auto masterDelta = SIMDFloat::fromRawArray(phaseDeltas[1] + row);
+    const auto inverseMasterDelta = SIMDFloat::fromRawArray(inversePhaseDeltas[1] + row);
+    auto pending = SIMDFloat::fromRawArray(syncCorrections + row);
+
+    for (int sample = 0; sample < numSamples; ++sample, dest += laneWidth)
+    {
+        SIMDFloat value;
+
+        if constexpr (modulationType == Modulation::phase)
+            value = sumPartials(modulatePhase(phase, modulator + sample * laneWidth, depth));
+        else
+            value = sumPartials(phase);
+
+        if constexpr (modulationType == Modulation::sync)
+        {
+            // Every partial is 0 at phase 0, so the jump is just the sum where the reset happens
+            // (which doubles the work while synced)
+            value += pending;
+            phase = syncStep(sumPartials, 0.0f, phase, delta, SIMDFloat::fromRawArray(modulator + sample * laneWidth),
+                             masterDelta, inverseMasterDelta, value, pending);
+        }
+        else
+        {
+            // Advance and wrap back into 0..1 (the phase is never negative, so truncating is flooring)
+            phase += delta;
+            phase -= SIMDFloat::truncate(phase);
+        }
+
+        value.copyToRawArray(dest);
+    }
+
+    phase.copyToRawArray(phases[oscIndex] + row);
+
+    if constexpr (modulationType == Modulation::sync)
+        pending.copyToRawArray(syncCorrections + row);
+}
+
+template <int Points, VoiceBank::Modulation modulationType>
+void VoiceBank::renderAnalyticChunk(const int oscIndex, const int unisonIndex, const int firstLane, const int numSamples, const float* modulator, float* dest)
+{
+    switch (waveforms[oscIndex])
+    {
+    case Waveform::square:
+        renderAnalyticKernel<Waveform::square, Points, modulationType>(oscIndex, unisonIndex, firstLane, numSamples, modulator, dest);
+        break;
+    case Waveform::saw:
+        renderAnalyticKernel<Waveform::saw, Points, modulationType>(oscIndex, unisonIndex, firstLane, numSamples, modulator, dest);
+        break;
+    case Waveform::triangle:
+        renderAnalyticKernel<Waveform::triangle, Points, modulationType>(oscIndex, unisonIndex, firstLane, numSamples, modulator, dest);
+        break;
+    case Waveform::sine:
+    case Waveform::noise: // Noise is handled by renderOscillatorChunk
+    case Waveform::pinkNoise:
+    case Waveform::brownNoise:
+    case Waveform::wavetable: // Handled by renderShapeChunk
+    case Waveform::additive:
+    default:
+        renderAnalyticKernel<Waveform::sine, Points, modulationType>(oscIndex, unisonIndex, firstLane, numSamples, modulator, dest);
+        break;
+    }
+}
+
+template <VoiceBank::Waveform waveform, int Points, VoiceBank::Modulation modulationType>
+void VoiceBank::renderAnalyticKernel(const int oscIndex, const int unisonIndex, const int firstLane, const int numSamples, const float* modulator, float* dest)
+{
+    // The sync corrections are 2-point, so a synced shape uses the same width for its own
+    // jumps: the restart correction has to cancel the one the shape puts at phase 0.
+    // Under phase modulation the corrections use the unmodulated phase increment.
+    constexpr int shapePoints = modulationType == Modulation::sync ? 2 : Points;
+    const int row = unisonIndex * numLanes + firstLane;
+
+    auto phase = SIMDFloat::fromRawArray(phases[oscIndex] + row);
+    const auto delta = SIMDFloat::fromRawArray(phaseDeltas[oscIndex] + row);
+    const auto inverseDelta = SIMDFloat::fromRawArray(inversePhaseDeltas[oscIndex] + row);
+    const auto depth = SIMDFloat::expand(modulationAmount * maxModulationDepth);
+
+    // Only used for hard sync, where oscillator 2 is the master
+    const auto masterDelta = SIMDFloat::fromRawArray(phaseDeltas[1] + row);
+    const auto inverseMasterDelta = SIMDFloat::fromRawArray(inversePhaseDeltas[1] + row);
+    auto pending = SIMDFloat::fromRawArray(syncCorrections + row);
+
+    for (int sample = 0; sample < numSamples; ++sample, dest += laneWidth)
+    {
+        SIMDFloat value;
+
+        if constexpr (modulationType == Modulation::phase)
+            value = analyticShape<waveform, shapePoints>(modulatePhase(phase, modulator + sample * laneWidth, depth), delta, inverseDelta);
+        else
+            value = analyticShape<waveform, shapePoints>(phase, delta, inverseDelta);
+
+        if constexpr (modulationType == Modulation::sync)
+        {
+            value += pending;
+            phase = syncStep([] (const SIMDFloat p) { return naiveShape(waveform, p); }, naturalJump(waveform), phase, delta,
+                             SIMDFloat::fromRawArray(modulator + sample * laneWidth), masterDelta, inverseMasterDelta, value, pending);
+        }
+        else
+        {
+            // Advance and wrap back into 0..1 (the phase is never negative, so truncating is flooring)
+            phase += delta;
+            phase -= SIMDFloat::truncate(phase);
+        }
+
+        value.copyToRawArray(dest);
+    }
+
+    phase.copyToRawArray(phases[oscIndex] + row);
+
+    if constexpr (modulationType == Modulation::sync)
+        pending.copyToRawArray(syncCorrections + row);
+}
+
+// Steps an oscillator that is only used as the hard sync master, writing out its phases
+void VoiceBank::advancePhases(const int oscIndex, const int unisonIndex, const int firstLane, const int numSamples, float* dest)
+{
+    const int row = unisonIndex * numLanes + firstLane;
+    auto phase = SIMDFloat::fromRawArray(phases[oscIndex] + row);
+    const auto delta = SIMDFloat::fromRawArray(phaseDeltas[oscIndex] + row);
+
+    for (int sample = 0; sample < numSamples; ++sample, dest += laneWidth)
+    {
+        phase.copyToRawArray(dest);
+        phase += delta;
+        phase -= SIMDFloat::truncate(phase);
+    }
+
+    phase.copyToRawArray(phases[oscIndex] + row);
+}
+
+// Adds a chunk of one oscillator copy into left and right (rows stride apart), with the copy's pan and the voice gains
+void VoiceBank::mixChunk(const int oscIndex, const int unisonIndex, const int firstLane, const int numSamples, const float* values,
+                         float* left, float* right, const int stride)
+{
+    const auto& settings = getUnison(oscIndex);
+    const auto gain = SIMDFloat::fromRawArray(gains + firstLane);
+
+    // Noise ignores unison, it keeps the plain voice gain
+    const bool noise = isNoise(waveforms[oscIndex]);
+    const auto leftGain = noise ? gain : gain * settings.leftGains[unisonIndex];
+    const auto rightGain = noise ? gain : gain * settings.rightGains[unisonIndex];
+
+    for (int sample = 0; sample < numSamples; ++sample, values += laneWidth, left += stride)
+    {
+        const auto value = SIMDFloat::fromRawArray(values);
+        SIMDFloat::multiplyAdd(SIMDFloat::fromRawArray(left), value, leftGain).copyToRawArray(left);
+
+        if (right != nullptr)
+        {
+            SIMDFloat::multiplyAdd(SIMDFloat::fromRawArray(right), value, rightGain).copyToRawArray(right);
+            right += stride;
+        }
+    }
+}
+
+void VoiceBank::copyVoiceOutput(const int voiceIndex, float* left, float* right, const int numSamples) const
+{
+    jassert(juce::isPositiveAndBelow(voiceIndex, numLanes));
+
+    const auto* leftSource = outputs[0] + voiceIndex;
+    const auto* rightSource = (stereoOutput ? outputs[1] : outputs[0]) + voiceIndex;
+
+    for (int sample = 0; sample < numSamples; ++sample, leftSource += numLanes)
+        left[sample] = *leftSource;
+
+    if (right != nullptr)
+        for (int sample = 0; sample < numSamples; ++sample, rightSource += numLanes)
+            right[sample] = *rightSource;
+}
@@ -0,0 +1,289 @@
+/*
+  ==============================================================================
+
+    VoiceBank.h
+    Created: 17 Oct 2026 10:12:31am
+    Author:  max
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Wavetable.h"
+#include "NoiseGenerator.h"
+#include "LadderFilterBank.h"
+#include "StateVariableFilterBank.h"
+#include "VoiceOversampler.h"
+
+// Keeps the oscillator state of all voices in structure-of-arrays form, so the
+// oscillators of several voices can be advanced together in the lanes of one
+// SIMD register (4 voices with SSE/NEON, 8 with AVX) instead of one after another.
+//
+// Each oscillator can play up to maxUnison detuned copies of itself. Unison voice u of
+// every voice lives in its own row of numLanes entries, so the rows are rendered one
+// after another with the same SIMD kernels and summed (and spread across left and
+// right) before the voices' filters ever see them.
+//
+// All enabled oscillators are mixed in a single pass over the block: it is rendered in short
+// chunks, and each chunk gets every copy of every oscillator (and any modulation between
+// them) added in while the outputs are still in cache. The voices' filters run on the chunk
+// right after, a register of voices at a time (see LadderFilterBank and StateVariableFilterBank).
+// Every voice has a second filter of the same type in the lane numLanes above its first one, and
+// with it routed in the pair goes through the chunk together. A register whose filters are all
+// wide open for the whole block skips them, crossfading out of and back into them.
+//
+// With oversampling on, a register of voices whose resonance or pitch is high enough to alias
+// renders its oscillators and filters at 2x or 4x the sample rate instead, and VoiceOversampler
+// brings every chunk back down. The other registers keep running at the sample rate.
+class VoiceBank
+{
+public:
+    using SIMDFloat = juce::dsp::SIMDRegister<float>;
+
+    static constexpr int numOscillators = 3;
+    static constexpr int laneWidth = static_cast<int>(SIMDFloat::size());
+    static constexpr int maxVoices = 64; // One bit per voice in the active mask
+    static constexpr int maxUnison = 16; // Detuned copies per oscillator
+    static constexpr int maxPartials = 256; // Harmonics of the additive waveform
+    static constexpr int numFilters = 2; // Per voice, see FilterRouting
+
+    // Choices of the waveform parameters, in the same order. wavetable plays the table loaded
+    // with setUserWavetable (a sine until there is one), additive the spectrum set with
+    // setAdditiveSpectrum.
+    enum class Waveform { sine, square, saw, triangle, noise, pinkNoise, brownNoise, wavetable, additive };
+
+    // How square, saw and triangle are generated. The choice order matches the oscMode parameter.
+    enum class OscillatorMode
+    {
+        wavetable,      // Band-limited mip-mapped tables
+        polyBlep,       // Naive shapes with 2-point PolyBLEP/PolyBLAMP corrections
+        polyBlep4Point  // Same with 4-point corrections, less aliasing for a little more work
+    };
+
+    // What oscillator 2 does to oscillator 1. The choice order matches the oscModulation parameter.
+    // In every mode but mix oscillator 2 isn't heard on its own: it runs under each unison copy of
+    // oscillator 1 (with oscillator 1's detune) and only shapes it.
+    enum class Modulation
+    {
+        mix,   // All enabled oscillators are summed
+        phase, // Oscillator 2 modulates the phase of oscillator 1 (FM/PM)
+        ring,  // Oscillator 1 multiplied by oscillator 2
+        sync   // Oscillator 1 restarts its cycle whenever oscillator 2 does (hard sync)
+    };
+
+    // Which filter the voices go through. The choice order matches the filterType parameter.
+    enum class FilterType
+    {
+        ladder,       // Moog-style ladder, cutoff updated every chunk
+        stateVariable // Zero-delay-feedback SVF with morphing outputs, cutoff updated every sample
+    };
+
+    // How a voice's second filter joins in. The choice order matches the filter2Routing parameter.
+    enum class FilterRouting
+    {
+        off,     // Only the first filter
+        serial,  // The first filter feeds the second
+        parallel // Both filter the oscillators, their outputs are averaged
+    };
+
+    VoiceBank();
+    void prepareToPlay(double sampleRate, int samplesPerBlock, int numVoices);
+    void startVoice(const int voiceIndex, const float frequency, const float gain);
+    void stopVoice(const int voiceIndex);
+    void updateWaveform(const Waveform waveform, const int oscIndex);
+
+    // Table for the wavetable waveform of an oscillator. It isn't owned and has to outlive its use here.
+    void setUserWavetable(const int oscIndex, const Wavetable* table);
+
+    // Morph position (0..1 across the frames of a multi-frame table) for every sample, so it can be
+    // modulated at audio rate. positions[0] belongs to output sample firstSample, and the data has to
+    // cover the samples of the render calls that follow. Without any, an oscillator plays frame 0.
+    void setWavetablePositions(const int oscIndex, const float* positions, const int firstSample);
+
+    // Amplitudes of harmonics 1..numPartials for the additive waveform of an oscillator. Harmonic
+    // k is sin(2pi k (p - 1/2)) at phase p, so a single partial of 1 is the sine waveform.
+    void setAdditiveSpectrum(const int oscIndex, const float* amplitudes, const int numPartials);
+    void setOscEnabled(const bool osc1, const bool osc2, const bool osc3);
+    void setOscillatorMode(const OscillatorMode newMode);
+    void setNoiseSeed(const juce::uint32 seed) { noiseGenerator.setSeed(seed); }
+
+    // Transposition of an oscillator against the note, in semitones
+    void setOscPitch(const int oscIndex, const float semitones);
+
+    // amount (0..1) is the depth of phase modulation and the wet level of ring modulation, sync ignores it
+    void setModulation(const Modulation newModulation, const float amount);
+
+    // numVoices copies spread evenly over +-detuneCents and panned over +-spread. blend is the
+    // level of the outer copies relative to the centre one(s), the sum is kept at constant power.
+    void setUnison(const int oscIndex, const int numVoices, const float detuneCents, const float spread, const float blend);
+
+    // startSample is where the block sits in the output buffer, it lines up the position data
+    void render(const int startSample, const int numSamples);
+
+    // render in two steps, for spreading the registers of voices over threads: beginBlock, then
+    // renderGroup for every group 0..getNumGroups() - 1. The groups share no state while they
+    // render, so they can go in any order or at the same time, with the same output as render.
+    void beginBlock(const int startSample, const int numSamples);
+    void renderGroup(const int group);
+    int getNumGroups() const noexcept { return numLanes / laneWidth; }
+
+    // False while none of a group's voices is sounding, renderGroup has nothing to do for it then
+    bool isGroupActive(const int group) const noexcept;
+
+    // Switching type clears the state of the filters switched to
+    void setFilterType(const FilterType newType);
+    FilterType getFilterType() const noexcept { return filterType; }
+
+    // Switching the second filters in clears their state
+    void setFilterRouting(const FilterRouting newRouting);
+    FilterRouting getFilterRouting() const noexcept { return filterRouting; }
+
+    // Resonance of one of a voice's filters (both types), which also decides whether it needs oversampling
+    void setVoiceResonance(const int voiceIndex, const int filterIndex, const float resonance);
+
+    // Oversampling factor (1, 2 or 4) of the oscillators and filters. It is only paid for where it
+    // is heard: a register of voices is oversampled while one of them has a resonance or a highest
+    // oscillator pitch past a threshold. Turning it on or off clicks, the latency changes.
+    void setOversampling(const int factor);
+
+    // Samples the output lags the notes by, the delay of the decimation filters while oversampling is on
+    int getLatency() const noexcept { return getLatency(oversampling); }
+    static int getLatency(const int factor) noexcept { return factor > 1 ? VoiceOversampler::latency : 0; }
+
+    // The lane of the filter banks that holds one of a voice's filters
+    int getFilterLane(const int voiceIndex, const int filterIndex) const noexcept { return filterIndex * numLanes + voiceIndex; }
+
+    // Two filters of each type per voice, see getFilterLane. The cutoffs of the current type have to
+    // be set for the block before render, for the second filters too while they are routed in.
+    LadderFilterBank& getLadderFilters() noexcept { return ladderFilters; }
+    StateVariableFilterBank& getStateVariableFilters() noexcept { return stateVariableFilters; }
+
+    // True if the last rendered block has different left and right channels (spread unison)
+    bool isStereo() const noexcept { return stereoOutput; }
+
+    // Copies a voice's left channel into left, and its right channel into right if that isn't
+    // null (for a mono block both get the same samples)
+    void copyVoiceOutput(const int voiceIndex, float* left, float* right, const int numSamples) const;
+
+    // Bit i is set while voice i is sounding
+    juce::uint64 getActiveVoiceMask() const noexcept { return activeVoiceMask.load(); }
+
+private:
+    static bool isNoise(const Waveform waveform) noexcept { return waveform == Waveform::noise || waveform == Waveform::pinkNoise || waveform == Waveform::brownNoise; }
+    struct Unison
+    {
+        int numVoices = 1;
+        float detuneCents = 0.0f;
+        float spread = 0.0f;
+        float blend = 1.0f;
+
+        float ratios[maxUnison] = {}; // Frequency of each copy relative to the note
+        float leftGains[maxUnison] = {};
+        float rightGains[maxUnison] = {};
+        float maxRatio = 1.0f;
+    };
+
+    // The oscillators are rendered in chunks this long, small enough for the intermediate
+    // results of all of them to stay in L1 until they are mixed into the output
+    static constexpr int chunkSize = 32;
+    static_assert(chunkSize == LadderFilterBank::controlInterval, "Each chunk is filtered with one cutoff target");
+    static_assert(chunkSize <= StateVariableFilterBank::maxChunkSize, "The filters take a chunk at a time");
+    static_assert(chunkSize <= VoiceOversampler::maxChunkSize, "So does the oversampler");
+
+    // Oscillator 2 borrows oscillator 1's unison while it modulates it
+    const Unison& getUnison(const int oscIndex) const noexcept { return oscIndex == 1 && oscModulation != Modulation::mix ? unison[0] : unison[oscIndex]; }
+    int getNumRows(const int oscIndex) const noexcept { return isNoise(waveforms[oscIndex]) ? 1 : getUnison(oscIndex).numVoices; }
+
+    void updateLaneFrequencies(const int oscIndex, const int lane);
+    void renderModulatedChunk(const int unisonIndex, const int firstLane, const int numSamples, float* modulator, float* dest);
+    void renderOscillatorChunk(const int oscIndex, const int unisonIndex, const int firstLane, const int numSamples,
+                               const Modulation modulation, const float* modulator, float* dest);
+    template <Modulation modulationType>
+    void renderShapeChunk(const int oscIndex, const int unisonIndex, const int firstLane, const int numSamples, const float* modulator, float* dest);
+    template <Modulation modulationType, bool morphing>
+    void renderWavetableChunk(const int oscIndex, const int unisonIndex, const int firstLane, const int numSamples, const float* modulator, float* dest);
+    template <Modulation modulationType>
+    void renderAdditiveChunk(const int oscIndex, const int unisonIndex, const int firstLane, const int numSamples, const float* modulator, float* dest);
+    template <int Points, Modulation modulationType>
+    void renderAnalyticChunk(const int oscIndex, const int unisonIndex, const int firstLane, const int numSamples, const float* modulator, float* dest);
+    template <Waveform waveform, int Points, Modulation modulationType>
+    void renderAnalyticKernel(const int oscIndex, const int unisonIndex, const int firstLane, const int numSamples, const float* modulator, float* dest);
+    void advancePhases(const int oscIndex, const int unisonIndex, const int firstLane, const int numSamples, float* dest);
+    void mixChunk(const int oscIndex, const int unisonIndex, const int firstLane, const int numSamples, const float* values,
+                  float* left, float* right, const int stride);
+    void filterChunk(const int firstLane, const int startSample, const bool transparent, float* left, float* right, const int stride, const int numSamples);
+    void runFilters(const int firstLane, const int startSample, float* left, float* right, const int stride, const int numSamples);
+    bool areFiltersTransparent(const int firstLane, const int numSamples) const;
+    float getBypassGain() const noexcept;
+    bool wantsOversampling(const int firstLane, const bool engaged) const;
+    void scalePhaseDeltas(const int firstLane, const float scale);
+
+    double currentSampleRate = 44100.0;
+    int maxBlockSize = 0;
+    int numLanes = 0; // Number of voices rounded up to a whole number of SIMD registers
+
+    Waveform waveforms[numOscillators] = { Waveform::sine, Waveform::sine, Waveform::sine };
+    bool oscEnabled[numOscillators] = { true, true, true };
+    const Wavetable* wavetables[numOscillators] = {}; // Band-limited table per oscillator (unused for noise)
+    const Wavetable* userWavetables[numOscillators] = {};
+    OscillatorMode oscillatorMode = OscillatorMode::wavetable;
+    Unison unison[numOscillators];
+    float pitchRatios[numOscillators] = { 1.0f, 1.0f, 1.0f };
+    Modulation oscModulation = Modulation::mix;
+    float modulationAmount = 0.0f;
+    bool stereoOutput = false;
+
+    float additiveSpectra[numOscillators][maxPartials] = {};
+    int numAdditivePartials[numOscillators] = {};
+
+    const float* wavetablePositions[numOscillators] = {};
+    int wavetablePositionStarts[numOscillators] = {}; // Output sample of wavetablePositions[osc][0]
+    int oversampling = 1; // Factor the groups that need it run at
+
+    // The block being rendered, set by beginBlock and only read by the groups
+    int blockStartSample = 0; // Output sample the block starts at
+    int blockNumSamples = 0;
+    int blockNumRows = 0; // Unison rows of the oscillators heard, 0 with none of them on
+    bool blockHeard[numOscillators] = {};
+    bool blockModulating = false; // Oscillator 2 shapes oscillator 1 instead of being mixed in
+
+    // State of a register of voices that only its own renderGroup writes. A cache line each,
+    // so groups rendering on different threads don't keep taking it from each other.
+    struct alignas(64) Group
+    {
+        int oversamplingShift = 0; // log2 of the factor the group runs at this block
+        int chunkStartSample = 0; // Output sample the chunk being rendered starts at
+        bool filtersSkipped = false; // Set while its filters aren't run at all
+    };
+
+    Group& getGroup(const int firstLane) noexcept { return groups[static_cast<size_t>(firstLane / laneWidth)]; }
+    const Group& getGroup(const int firstLane) const noexcept { return groups[static_cast<size_t>(firstLane / laneWidth)]; }
+
+    // Per-lane state, all arrays are numLanes long (or maxUnison rows of numLanes) and SIMD aligned
+    static constexpr size_t stateAlignment = 64; // One cache line
+    juce::HeapBlock<char> stateMemory;
+    float* phases[numOscillators] = {}; // Normalised phase (0..1), phases[osc][unison * numLanes + lane]
+    float* phaseDeltas[numOscillators] = {}; // Phase increment per sample, same layout
+    float* inversePhaseDeltas[numOscillators] = {}; // Samples per cycle, 0 for lanes that never played
+    float* syncCorrections = nullptr; // Hard sync correction still owed to the next sample of oscillator 1, same layout
+    float* noteDeltas = nullptr; // Phase increment of each voice's note before detuning
+    float* gains = nullptr; // Velocity gain of each voice
+    float* resonances = nullptr; // Filter resonance of each voice, resonances[filter * numLanes + lane]
+    float* bypassLevels = nullptr; // How far each voice has crossfaded from its filters (0) to skipping them (1)
+    float* outputs[2] = {}; // Rendered left/right blocks, interleaved: outputs[channel][sample * numLanes + lane]
+
+    std::atomic<juce::uint64> activeVoiceMask { 0 }; // Atomic, voices on different threads stop their lanes concurrently
+    NoiseGenerator noiseGenerator;
+    FilterType filterType = FilterType::ladder;
+    FilterRouting filterRouting = FilterRouting::off;
+    CutoffTable cutoffTable; // Shared by all the voices' ladder filters
+    LadderFilterBank ladderFilters;
+    StateVariableFilterBank stateVariableFilters;
+    VoiceOversampler oversampler;
+    std::vector<Group> groups; // One per register of voices, see getGroup
+    std::vector<int> mipLevels; // Wavetable mip level per oscillator and lane, mipLevels[osc * numLanes + lane]
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VoiceBank)
+};
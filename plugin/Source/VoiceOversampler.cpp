@@ -0,0 +1,239 @@
+/*
+  ==============================================================================
+
+    VoiceOversampler.cpp
+    Created: 18 Oct 2026 2:24:47am
+    Author:  max
+
+  ==============================================================================
+*/
+
+#include "VoiceOversampler.h"
+
+namespace
+{
+    using SIMDFloat = VoiceOversampler::SIMDFloat;
+    constexpr int laneWidth = VoiceOversampler::laneWidth;
+
+    // Odd taps of the two half-band filters, nearest the centre first (the centre tap is 0.5).
+    // Kaiser-windowed sincs: the long one passes up to 0.4 fs and keeps everything from 0.6 fs
+    // of the 2x band 75 dB down, the short one only has to clear what the 4x band would fold
+    // onto that from above 1.4 fs, which it does by 64 dB.
+    constexpr float longTaps[] = { 0.31637645f, -0.10037871f, 0.054511404f, -0.033442578f, 0.021129309f, -0.013214444f,
+                                   0.0079820061f, -0.0045593734f, 0.0024039126f, -0.0011291391f, 0.00044220907f, -0.00012105038f };
+    constexpr float shortTaps[] = { 0.30937047f, -0.081742395f, 0.029926403f, -0.0092410065f, 0.0016865309f };
+
+    // Delay of each filter in its input samples: the centre sits numTaps - 1 pairs behind the newest
+    constexpr int longDelay = 2 * (static_cast<int>(std::size(longTaps)) - 1);
+    constexpr int shortDelay = 2 * (static_cast<int>(std::size(shortTaps)) - 1);
+    static_assert(VoiceOversampler::latency == longDelay / 2 + shortDelay / 4, "4x goes through both filters");
+
+    constexpr int fadeLength = 32; // Output samples a change of factor crossfades over
+
+    // Halves the rate of work (rows of laneWidth). Output n is centred on row centre + 2n, which
+    // has to be the first of a pair, and is written to out[n * laneWidth].
+    template <size_t numTaps>
+    void decimate(const float (&taps)[numTaps], const float* work, int centre, float* out, const int numOutputs) noexcept
+    {
+        for (int n = 0; n < numOutputs; ++n, centre += 2, out += laneWidth)
+        {
+            auto sum = SIMDFloat::fromRawArray(work + centre * laneWidth) * 0.5f;
+
+            for (size_t tap = 0; tap < numTaps; ++tap)
+            {
+                const int distance = 2 * static_cast<int>(tap) + 1;
+                const auto pair = SIMDFloat::fromRawArray(work + (centre - distance) * laneWidth)
+                                + SIMDFloat::fromRawArray(work + (centre + distance) * laneWidth);
+                sum = SIMDFloat::multiplyAdd(sum, pair, SIMDFloat::expand(taps[tap]));
+            }
+
+            sum.copyToRawArray(out);
+        }
+    }
+
+    // Moves rows of lanes between the history (rows of numLanes) and the work buffers (rows of laneWidth)
+    void loadRows(const float* source, const int sourceStride, float* dest, const int numRows) noexcept
+    {
+        for (int row = 0; row < numRows; ++row)
+            SIMDFloat::fromRawArray(source + row * sourceStride).copyToRawArray(dest + row * laneWidth);
+    }
+
+    void storeRows(const float* source, float* dest, const int destStride, const int numRows) noexcept
+    {
+        for (int row = 0; row < numRows; ++row)
+            SIMDFloat::fromRawArray(source + row * laneWidth).copyToRawArray(dest + row * destStride);
+    }
+}
+
+void VoiceOversampler::prepare(int lanes)
+{
+    numLanes = ((lanes + laneWidth - 1) / laneWidth) * laneWidth;
+
+    // Same single aligned allocation as the voice bank, each channel's history in one piece
+    stateMemory.calloc(static_cast<size_t>(2 * numHistoryRows * numLanes) * sizeof(float) + stateAlignment);
+    auto* data = juce::snapPointerToAlignment(reinterpret_cast<float*>(stateMemory.getData()), stateAlignment);
+
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        plainHistory[channel] = data;
+        longStageHistory[channel] = plainHistory[channel] + plainLength * numLanes;
+        shortStageHistory[channel] = longStageHistory[channel] + longStageLength * numLanes;
+        data += numHistoryRows * numLanes;
+    }
+
+    reset();
+}
+
+void VoiceOversampler::reset()
+{
+    std::fill(plainHistory[0], plainHistory[0] + 2 * numHistoryRows * numLanes, 0.0f);
+    groups.assign(static_cast<size_t>(numLanes / laneWidth), Group());
+}
+
+void VoiceOversampler::reset(const int lane)
+{
+    for (auto* history : plainHistory)
+        for (int row = 0; row < numHistoryRows; ++row)
+            history[row * numLanes + lane] = 0.0f;
+}
+
+void VoiceOversampler::copyLeftToRight()
+{
+    std::copy(plainHistory[0], plainHistory[0] + numHistoryRows * numLanes, plainHistory[1]);
+}
+
+int VoiceOversampler::beginBlock(const int firstLane, const int wantedFactor)
+{
+    jassert(wantedFactor == 1 || wantedFactor == 2 || wantedFactor == maxFactor);
+    auto& group = groups[static_cast<size_t>(firstLane / laneWidth)];
+
+    // Away from an oversampled factor only once its output has faded out
+    if (group.factor > 1 && group.factor != wantedFactor)
+    {
+        group.fadeTarget = 0.0f;
+
+        if (group.fade > 0.0f)
+            return group.factor;
+
+        group.factor = 1;
+    }
+
+    if (group.factor == 1 && wantedFactor > 1)
+    {
+        prime(firstLane, wantedFactor);
+        group.factor = wantedFactor;
+    }
+
+    group.fadeTarget = group.factor > 1 ? 1.0f : 0.0f;
+    return group.factor;
+}
+
+void VoiceOversampler::prime(const int firstLane, const int factor)
+{
+    // Fills the inputs the filters would have seen in with the plain samples, interpolated at
+    // each input's time. samplesAgo counts back from the newest plain sample, so the newest
+    // oversampled inputs (which come after it) just repeat it.
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        const float* plain = plainHistory[channel] + firstLane;
+
+        auto plainAt = [plain, this] (const float samplesAgo)
+        {
+            constexpr auto newest = static_cast<float>(plainLength - 1);
+            const float position = juce::jlimit(0.0f, newest, newest - samplesAgo);
+            const int row = juce::jmin(static_cast<int>(position), plainLength - 2);
+            const auto before = SIMDFloat::fromRawArray(plain + row * numLanes);
+            const auto after = SIMDFloat::fromRawArray(plain + (row + 1) * numLanes);
+            return before + (after - before) * (position - static_cast<float>(row));
+        };
+
+        // At 4x the long filter's inputs come out of the short one, which delays them
+        const float longNewest = (factor == maxFactor ? static_cast<float>(shortDelay) * 0.25f : 0.0f) - 0.5f;
+
+        for (int row = 0; row < longStageLength; ++row)
+            plainAt(longNewest + static_cast<float>(longStageLength - 1 - row) * 0.5f).copyToRawArray(longStageHistory[channel] + row * numLanes + firstLane);
+
+        if (factor == maxFactor)
+            for (int row = 0; row < shortStageLength; ++row)
+                plainAt(-0.75f + static_cast<float>(shortStageLength - 1 - row) * 0.25f).copyToRawArray(shortStageHistory[channel] + row * numLanes + firstLane);
+    }
+}
+
+void VoiceOversampler::process(const int firstLane, const float* left, const float* right, float* leftOut, float* rightOut,
+                               const int outputStride, const int numSamples)
+{
+    auto& group = groups[static_cast<size_t>(firstLane / laneWidth)];
+    const int factor = group.factor;
+    jassert(numSamples * factor <= maxChunkSize);
+
+    // The crossfade between plain and decimated samples, the same for both channels
+    float fades[maxChunkSize];
+    constexpr float fadeStep = 1.0f / static_cast<float>(fadeLength);
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        group.fade = group.fadeTarget > group.fade ? juce::jmin(group.fadeTarget, group.fade + fadeStep)
+                                                   : juce::jmax(group.fadeTarget, group.fade - fadeStep);
+        fades[sample] = group.fade;
+    }
+
+    const float* inputs[2] = { left, right };
+    float* outputs[2] = { leftOut, rightOut };
+    const int numChannels = right != nullptr ? 2 : 1;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const float* input = inputs[channel];
+        float* output = outputs[channel];
+
+        // The plain samples, every factor-th input, queue up behind the history
+        alignas(stateAlignment) float plain[(plainLength + maxChunkSize) * laneWidth];
+        loadRows(plainHistory[channel] + firstLane, numLanes, plain, plainLength);
+
+        for (int sample = 0; sample < numSamples; ++sample)
+            SIMDFloat::fromRawArray(input + sample * factor * laneWidth).copyToRawArray(plain + (plainLength + sample) * laneWidth);
+
+        storeRows(plain + numSamples * laneWidth, plainHistory[channel] + firstLane, numLanes, plainLength);
+        const float* delayedPlain = plain + (plainLength - latency) * laneWidth;
+
+        if (factor == 1)
+        {
+            for (int sample = 0; sample < numSamples; ++sample)
+                SIMDFloat::fromRawArray(delayedPlain + sample * laneWidth).copyToRawArray(output + sample * outputStride);
+
+            continue;
+        }
+
+        // Down to 2x through the short filter, or straight in. At 2x the long filter reads that
+        // much further back instead, so both factors come out equally late.
+        alignas(stateAlignment) float longWork[(longStageLength + maxChunkSize) * laneWidth];
+        loadRows(longStageHistory[channel] + firstLane, numLanes, longWork, longStageLength);
+        const int numLongInputs = 2 * numSamples;
+
+        if (factor == maxFactor)
+        {
+            alignas(stateAlignment) float shortWork[(shortStageLength + maxChunkSize) * laneWidth];
+            loadRows(shortStageHistory[channel] + firstLane, numLanes, shortWork, shortStageLength);
+            std::copy(input, input + 2 * numLongInputs * laneWidth, shortWork + shortStageLength * laneWidth);
+
+            decimate(shortTaps, shortWork, shortStageLength - shortDelay, longWork + longStageLength * laneWidth, numLongInputs);
+            storeRows(shortWork + 2 * numLongInputs * laneWidth, shortStageHistory[channel] + firstLane, numLanes, shortStageLength);
+        }
+        else
+        {
+            std::copy(input, input + numLongInputs * laneWidth, longWork + longStageLength * laneWidth);
+        }
+
+        alignas(stateAlignment) float decimated[maxChunkSize * laneWidth];
+        const int lateness = factor == maxFactor ? 0 : shortDelay / 2;
+        decimate(longTaps, longWork, longStageLength - longDelay - lateness, decimated, numSamples);
+        storeRows(longWork + numLongInputs * laneWidth, longStageHistory[channel] + firstLane, numLanes, longStageLength);
+
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            const auto plainValue = SIMDFloat::fromRawArray(delayedPlain + sample * laneWidth);
+            const auto decimatedValue = SIMDFloat::fromRawArray(decimated + sample * laneWidth);
+            SIMDFloat::multiplyAdd(plainValue, decimatedValue - plainValue, SIMDFloat::expand(fades[sample])).copyToRawArray(output + sample * outputStride);
+        }
+    }
+}
@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    VoiceOversampler.h
+    Created: 18 Oct 2026 2:24:47am
+    Author:  max
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Brings voices that the voice bank renders at 2x or 4x the sample rate back down to it, one
+// voice per SIMD lane like the filter banks. Each halving is a polyphase half-band FIR: the
+// even input samples only go through the centre tap, so a pair of inputs costs one symmetric
+// FIR over the odd ones. 4x is a short half-band to 2x followed by the long one.
+//
+// The factor is chosen per register of voices and can change while they play. Every factor
+// has the same latency (1x is simply delayed), and a change crossfades between the decimated
+// output and the plain every-Nth-sample one, which is always kept up to date. A filter that is
+// switched in starts from history filled in from the plain output, so it has nothing to settle.
+class VoiceOversampler
+{
+public:
+    using SIMDFloat = juce::dsp::SIMDRegister<float>;
+    static constexpr int laneWidth = static_cast<int>(SIMDFloat::size());
+    static constexpr int maxFactor = 4;
+    static constexpr int maxChunkSize = 32; // Most input samples process takes at once
+    static constexpr int latency = 13; // Output samples, whatever the factor
+
+    VoiceOversampler() = default;
+    void prepare(int numLanes);
+
+    // Clears all history and puts every group back at 1x
+    void reset();
+
+    // Clears a lane's history, for a voice that starts a new note
+    void reset(const int lane);
+
+    int getFactor(const int firstLane) const noexcept { return groups[static_cast<size_t>(firstLane / laneWidth)].factor; }
+
+    // The factor (1, 2 or 4) the lanes firstLane..firstLane + laneWidth - 1 render the coming
+    // block at. Moving away from a factor first fades out of it, so this returns the old one
+    // until that is done.
+    int beginBlock(const int firstLane, const int wantedFactor);
+
+    // Decimates numSamples * factor input samples of the lanes (left[s * laneWidth], right null
+    // for mono) into numSamples output samples at leftOut[s * outputStride] and rightOut.
+    void process(const int firstLane, const float* left, const float* right, float* leftOut, float* rightOut,
+                 const int outputStride, const int numSamples);
+
+    // Gives the right channel the left one's history, for a mono block that turns stereo
+    void copyLeftToRight();
+
+private:
+    struct Group
+    {
+        int factor = 1;
+        float fade = 0.0f; // 0 plays the plain samples, 1 the decimated ones
+        float fadeTarget = 0.0f;
+    };
+
+    // History rows per channel: plain samples, then the inputs of the 2x and the 4x stage
+    static constexpr int plainLength = 32;
+    static constexpr int longStageLength = 50;
+    static constexpr int shortStageLength = 18;
+    static constexpr int numHistoryRows = plainLength + longStageLength + shortStageLength;
+
+    void prime(const int firstLane, const int factor);
+
+    static constexpr size_t stateAlignment = 64;
+
+    int numLanes = 0;
+    juce::HeapBlock<char> stateMemory;
+    float* plainHistory[2] = {}; // plainHistory[channel][row * numLanes + lane], newest row last
+    float* longStageHistory[2] = {};
+    float* shortStageHistory[2] = {};
+    std::vector<Group> groups; // One per register of lanes
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VoiceOversampler)
+};
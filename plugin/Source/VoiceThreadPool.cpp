@@ -0,0 +1,185 @@
+/*
+  ==============================================================================
+
+    VoiceThreadPool.cpp
+    Created: 17 Oct 2026 1:05:48pm
+    Author:  max
+
+  ==============================================================================
+*/
+
+#include "VoiceThreadPool.h"
+
+VoiceThreadPool::Worker::Worker(VoiceThreadPool& ownerPool, const int queueToUse)
+    : juce::Thread("MaxSynth voice worker"), pool(ownerPool), queueIndex(queueToUse)
+{
+}
+
+void VoiceThreadPool::Worker::run()
+{
+    while (!threadShouldExit())
+    {
+        wakeUp.wait(-1);
+
+        if (threadShouldExit())
+            break;
+
+        pool.workOn(queueIndex);
+    }
+}
+
+VoiceThreadPool::VoiceThreadPool()
+{
+    queues = std::make_unique<TaskQueue[]>(1);
+}
+
+VoiceThreadPool::~VoiceThreadPool()
+{
+    setNumWorkers(0);
+}
+
+void VoiceThreadPool::setNumWorkers(const int numWorkers)
+{
+    const juce::ScopedLock sl(configurationLock);
+
+    // Stop the old workers
+    for (auto& worker : workers)
+    {
+        worker->signalThreadShouldExit();
+        worker->wakeUp.signal();
+    }
+
+    for (auto& worker : workers)
+        worker->stopThread(1000);
+
+    workers.clear();
+
+    // Start the new ones, queue 0 belongs to the thread calling forEach
+    queues = std::make_unique<TaskQueue[]>(static_cast<size_t>(numWorkers + 1));
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        workers.push_back(std::make_unique<Worker>(*this, i + 1));
+        workers.back()->startRealtimeThread(juce::Thread::RealtimeOptions{});
+    }
+}
+
+void VoiceThreadPool::run(const int numItems, const int itemsPerTask, ItemCallback callback, void* context)
+{
+    const int numTasks = (numItems + itemsPerTask - 1) / itemsPerTask;
+
+    // Never wait for setNumWorkers: while it is changing the workers, this thread does it all
+    const juce::ScopedTryLock stl(configurationLock);
+
+    // Not worth waking anybody up for a single task
+    if (!stl.isLocked() || workers.empty() || numTasks < 2)
+    {
+        for (int i = 0; i < numItems; ++i)
+            callback(context, i);
+
+        return;
+    }
+
+    jobCallback.store(callback);
+    jobContext.store(context);
+    jobNumItems.store(numItems);
+    jobItemsPerTask.store(itemsPerTask);
+    tasksRemaining.store(numTasks);
+
+    // Deal the tasks out in contiguous runs, so each thread mostly works on neighbouring voices
+    const int numQueues = getNumWorkers() + 1;
+
+    for (int q = 0; q < numQueues; ++q)
+    {
+        const auto begin = static_cast<juce::uint32>((numTasks * q) / numQueues);
+        const auto end = static_cast<juce::uint32>((numTasks * (q + 1)) / numQueues);
+        queues[static_cast<size_t>(q)].range.store(packRange(begin, end));
+    }
+
+    for (auto& worker : workers)
+        worker->wakeUp.signal();
+
+    // Help out, then sleep until the tasks that are still running on other threads are done.
+    // Exactly one signal comes per job, so this also consumes it when the last task ran here.
+    workOn(0);
+    jobFinished.wait(-1);
+}
+
+void VoiceThreadPool::workOn(const int queueIndex)
+{
+    for (;;)
+    {
+        int task = popTask(queueIndex);
+
+        if (task < 0)
+            task = stealTask(queueIndex);
+
+        if (task < 0)
+            return;
+
+        runTask(task);
+    }
+}
+
+void VoiceThreadPool::runTask(const int task)
+{
+    // Only read the job after having won the task, so a worker that is late from the
+    // previous job can never run a new task with the old callback
+    auto* callback = jobCallback.load();
+    auto* context = jobContext.load();
+    const int numItems = jobNumItems.load();
+    const int itemsPerTask = jobItemsPerTask.load();
+
+    const int begin = task * itemsPerTask;
+    const int end = juce::jmin(numItems, begin + itemsPerTask);
+
+    for (int i = begin; i < end; ++i)
+        callback(context, i);
+
+    if (tasksRemaining.fetch_sub(1) == 1)
+        jobFinished.signal();
+}
+
+int VoiceThreadPool::popTask(const int queueIndex)
+{
+    auto& range = queues[static_cast<size_t>(queueIndex)].range;
+    auto current = range.load();
+
+    for (;;)
+    {
+        const auto begin = static_cast<juce::uint32>(current);
+        const auto end = static_cast<juce::uint32>(current >> 32);
+
+        if (begin >= end)
+            return -1;
+
+        if (range.compare_exchange_weak(current, packRange(begin + 1, end)))
+            return static_cast<int>(begin);
+    }
+}
+
+int VoiceThreadPool::stealTask(const int queueIndex)
+{
+    const int numQueues = getNumWorkers() + 1;
+
+    // Start with the next queue along, so thieves don't all pile onto the same victim
+    for (int offset = 1; offset < numQueues; ++offset)
+    {
+        auto& range = queues[static_cast<size_t>((queueIndex + offset) % numQueues)].range;
+        auto current = range.load();
+
+        for (;;)
+        {
+            const auto begin = static_cast<juce::uint32>(current);
+            const auto end = static_cast<juce::uint32>(current >> 32);
+
+            if (begin >= end)
+                break;
+
+            if (range.compare_exchange_weak(current, packRange(begin, end - 1)))
+                return static_cast<int>(end - 1);
+        }
+    }
+
+    return -1;
+}
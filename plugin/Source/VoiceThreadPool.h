@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    VoiceThreadPool.h
+    Created: 17 Oct 2026 1:05:48pm
+    Author:  max
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Small real-time thread pool for spreading the voices of one block over several
+// cores. The items of a job are cut into tasks of at least minItemsPerTask items,
+// every thread (including the audio thread that calls forEach) gets its own queue
+// of tasks, and threads that run out of work steal from the back of the others'.
+// Nothing is allocated and no lock is waited for while a job runs: idle workers sleep on
+// their wakeUp event, and the calling thread sleeps on jobFinished once it has run out
+// of tasks to help with.
+class VoiceThreadPool
+{
+public:
+    VoiceThreadPool();
+    ~VoiceThreadPool();
+
+    // Starts or stops worker threads. Safe to call (from any thread but the one calling
+    // forEach) while a job runs: it waits for the job, and forEach runs everything on the
+    // calling thread instead of waiting while the workers are being changed.
+    void setNumWorkers(const int numWorkers);
+    int getNumWorkers() const noexcept { return static_cast<int>(workers.size()); }
+
+    void setMinItemsPerTask(const int minItems) noexcept { minItemsPerTask.store(juce::jmax(1, minItems)); }
+    int getMinItemsPerTask() const noexcept { return minItemsPerTask.load(); }
+
+    // Calls function(index) once for every index in 0..numItems-1 and returns when all calls are done
+    template <typename Function>
+    void forEach(const int numItems, Function& function)
+    {
+        forEach(numItems, getMinItemsPerTask(), function);
+    }
+
+    // Same with tasks of itemsPerTask items, for jobs whose items are too big to batch
+    template <typename Function>
+    void forEach(const int numItems, const int itemsPerTask, Function& function)
+    {
+        run(numItems, juce::jmax(1, itemsPerTask), [](void* context, int index) { (*static_cast<Function*>(context))(index); }, &function);
+    }
+
+private:
+    using ItemCallback = void (*)(void* context, int index);
+
+    // A task queue is a range of task indices packed into one atomic, the owner takes
+    // tasks from the front and thieves take them from the back
+    struct alignas(64) TaskQueue
+    {
+        std::atomic<juce::uint64> range { 0 };
+    };
+
+    class Worker : public juce::Thread
+    {
+    public:
+        Worker(VoiceThreadPool& ownerPool, const int queueToUse);
+        void run() override;
+
+        juce::WaitableEvent wakeUp;
+
+    private:
+        VoiceThreadPool& pool;
+        const int queueIndex;
+    };
+
+    void run(const int numItems, const int itemsPerTask, ItemCallback callback, void* context);
+    void workOn(const int queueIndex);
+    void runTask(const int task);
+    int popTask(const int queueIndex);
+    int stealTask(const int queueIndex);
+
+    static juce::uint64 packRange(const juce::uint32 begin, const juce::uint32 end) noexcept { return (static_cast<juce::uint64>(end) << 32) | begin; }
+
+    juce::CriticalSection configurationLock; // Held by setNumWorkers, and by forEach while a job runs
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::unique_ptr<TaskQueue[]> queues; // One per worker plus one for the calling thread
+    std::atomic<int> minItemsPerTask { 2 };
+
+    // The job that is currently running
+    std::atomic<ItemCallback> jobCallback { nullptr };
+    std::atomic<void*> jobContext { nullptr };
+    std::atomic<int> jobNumItems { 0 };
+    std::atomic<int> jobItemsPerTask { 1 };
+    std::atomic<int> tasksRemaining { 0 };
+    juce::WaitableEvent jobFinished; // Signalled by whichever thread finishes the job's last task
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VoiceThreadPool)
+};
@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+
+    Wavetable.cpp
+    Created: 17 Oct 2026 3:22:40pm
+    Author:  max
+
+  ==============================================================================
+*/
+
+#include "Wavetable.h"
+
+namespace
+{
+    // The oscillators used to be fed x = 2pi * phase - pi, so each series below is the
+    // band-limited version of the old lambda for that waveform at phase p:
+    //   sine      sin(2pi (p - 1/2))   = -sin(2pi p)
+    //   square    -1 then +1           = -(4/pi) sum over odd k of sin(2pi k p) / k
+    //   saw       2p - 1               = -(2/pi) sum over k of sin(2pi k p) / k
+    //   triangle  4|p - 1/2| - 1       = (8/pi^2) sum over odd k of cos(2pi k p) / k^2
+    void buildSeries(const Wavetable::BuiltIn type, std::vector<float>& sines, std::vector<float>& cosines)
+    {
+        const auto pi = juce::MathConstants<double>::pi;
+
+        sines.assign(Wavetable::maxHarmonics, 0.0f);
+        cosines.assign(Wavetable::maxHarmonics, 0.0f);
+
+        for (int k = 1; k <= Wavetable::maxHarmonics; ++k)
+        {
+            const bool odd = (k % 2) == 1;
+            auto& sine = sines[static_cast<size_t>(k - 1)];
+            auto& cosine = cosines[static_cast<size_t>(k - 1)];
+
+            switch (type)
+            {
+            case Wavetable::BuiltIn::sine:
+                sine = (k == 1) ? -1.0f : 0.0f;
+                break;
+            case Wavetable::BuiltIn::square:
+                sine = odd ? static_cast<float>(-4.0 / (pi * k)) : 0.0f;
+                break;
+            case Wavetable::BuiltIn::saw:
+                sine = static_cast<float>(-2.0 / (pi * k));
+                break;
+            case Wavetable::BuiltIn::triangle:
+                cosine = odd ? static_cast<float>(8.0 / (pi * pi * k * k)) : 0.0f;
+                break;
+            }
+        }
+    }
+
+    std::unique_ptr<Wavetable> createBuiltIn(const Wavetable::BuiltIn type)
+    {
+        std::vector<float> sines, cosines;
+        buildSeries(type, sines, cosines);
+
+        auto table = std::make_unique<Wavetable>();
+        table->setHarmonics(sines, cosines);
+        return table;
+    }
+}
+
+const Wavetable& Wavetable::getBuiltIn(const BuiltIn type)
+{
+    // Built on first use (the voice bank asks for them from its constructor, off the audio thread)
+    static const std::array<std::unique_ptr<Wavetable>, 4> builtIns {
+        createBuiltIn(BuiltIn::sine),
+        createBuiltIn(BuiltIn::square),
+        createBuiltIn(BuiltIn::saw),
+        createBuiltIn(BuiltIn::triangle)
+    };
+
+    return *builtIns[static_cast<size_t>(type)];
+}
+
+Wavetable::Wavetable(const int frameCount)
+    : numFrames(juce::jlimit(1, maxFrames, frameCount)),
+      tables(static_cast<size_t>(numFrames) * numLevels * (tableSize + 1), 0.0f)
+{
+}
+
+void Wavetable::setHarmonics(const std::vector<float>& sineAmplitudes, const std::vector<float>& cosineAmplitudes)
+{
+    // One cycle of a cosine, sin(2pi k n / N) and cos(2pi k n / N) are then just lookups at (k n) mod N
+    std::vector<double> cosineCycle(tableSize);
+
+    for (int n = 0; n < tableSize; ++n)
+        cosineCycle[static_cast<size_t>(n)] = std::cos(juce::MathConstants<double>::twoPi * n / tableSize);
+
+    std::vector<double> sum(tableSize);
+
+    for (int level = 0; level < numLevels; ++level)
+    {
+        const int numHarmonics = maxHarmonics >> level;
+        std::fill(sum.begin(), sum.end(), 0.0);
+
+        for (int k = 1; k <= numHarmonics; ++k)
+        {
+            const double sine = k <= static_cast<int>(sineAmplitudes.size()) ? sineAmplitudes[static_cast<size_t>(k - 1)] : 0.0;
+            const double cosine = k <= static_cast<int>(cosineAmplitudes.size()) ? cosineAmplitudes[static_cast<size_t>(k - 1)] : 0.0;
+
+            if (sine == 0.0 && cosine == 0.0)
+                continue;
+
+            for (int n = 0; n < tableSize; ++n)
+            {
+                const int cosIndex = (k * n) & (tableSize - 1);
+                const int sinIndex = (cosIndex + 3 * tableSize / 4) & (tableSize - 1); // sin(x) = cos(x - pi/2)
+                sum[static_cast<size_t>(n)] += sine * cosineCycle[static_cast<size_t>(sinIndex)] + cosine * cosineCycle[static_cast<size_t>(cosIndex)];
+            }
+        }
+
+        auto* data = tables.data() + getOffset(level, 0);
+
+        for (int n = 0; n < tableSize; ++n)
+            data[n] = static_cast<float>(sum[static_cast<size_t>(n)]);
+
+        data[tableSize] = data[0];
+    }
+}
+
+void Wavetable::setFrame(const int frame, const float* cycle)
+{
+    jassert(frame >= 0 && frame < numFrames);
+
+    constexpr int fftOrder = 11;
+    static_assert((1 << fftOrder) == tableSize, "The FFT has to cover exactly one cycle");
+    juce::dsp::FFT fft(fftOrder);
+
+    // The real-only transforms work in place on 2 * tableSize floats, bin k in [2k] (real) and [2k + 1] (imaginary)
+    std::vector<float> spectrum(2 * tableSize, 0.0f);
+    std::copy(cycle, cycle + tableSize, spectrum.begin());
+    fft.performRealOnlyForwardTransform(spectrum.data(), true);
+    spectrum[0] = spectrum[1] = 0.0f;
+
+    std::vector<float> levelSpectrum(2 * tableSize);
+
+    for (int level = 0; level < numLevels; ++level)
+    {
+        // Bins 1..numHarmonics are kept, everything above is cut
+        const auto numKept = static_cast<size_t>(2 * ((maxHarmonics >> level) + 1));
+        std::copy(spectrum.begin(), spectrum.begin() + static_cast<std::ptrdiff_t>(numKept), levelSpectrum.begin());
+        std::fill(levelSpectrum.begin() + static_cast<std::ptrdiff_t>(numKept), levelSpectrum.end(), 0.0f);
+        fft.performRealOnlyInverseTransform(levelSpectrum.data());
+
+        auto* data = tables.data() + getOffset(level, frame);
+        std::copy(levelSpectrum.begin(), levelSpectrum.begin() + tableSize, data);
+        data[tableSize] = data[0];
+    }
+}
+
+int Wavetable::getLevelForPhaseDelta(const float phaseDelta) noexcept
+{
+    // Level k is alias-free while (maxHarmonics >> k) * phaseDelta <= 0.5, i.e. 2^k >= 2 * maxHarmonics * phaseDelta
+    int level = 0;
+    float highestHarmonic = std::abs(phaseDelta) * static_cast<float>(maxHarmonics);
+
+    while (highestHarmonic > 0.5f && level < numLevels - 1)
+    {
+        highestHarmonic *= 0.5f;
+        ++level;
+    }
+
+    return level;
+}
@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    Wavetable.h
+    Created: 17 Oct 2026 3:22:40pm
+    Author:  max
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// One cycle of a waveform, stored as a mip-map of band-limited copies. Level k holds
+// only the lowest (maxHarmonics >> k) harmonics, so every octave up the keyboard plays
+// from a table with half as many harmonics and nothing ever folds back past Nyquist.
+//
+// A table can hold several frames (cycles), each with its own set of levels, for wavetables
+// loaded from files. The built-in tables have one.
+class Wavetable
+{
+public:
+    static constexpr int tableSize = 2048; // Samples per cycle
+    static constexpr int numLevels = 11; // One per octave, from 1024 harmonics down to 1
+    static constexpr int maxHarmonics = tableSize / 2;
+    static constexpr int maxFrames = 256;
+    static constexpr int frameSize = numLevels * (tableSize + 1); // Floats from a level of one frame to the same level of the next
+
+    // The built-in tables, in the order of the waveform parameter choices
+    enum class BuiltIn { sine, square, saw, triangle };
+    static const Wavetable& getBuiltIn(const BuiltIn type);
+
+    explicit Wavetable(const int numFrames = 1);
+
+    int getNumFrames() const noexcept { return numFrames; }
+
+    // Fills every level of frame 0 from a harmonic series: harmonic k (1-based, index k - 1) contributes
+    // sineAmplitudes[k-1] * sin(2pi k p) + cosineAmplitudes[k-1] * cos(2pi k p) at phase p
+    void setHarmonics(const std::vector<float>& sineAmplitudes, const std::vector<float>& cosineAmplitudes);
+
+    // Fills every level of a frame from one cycle of tableSize samples (the DC offset is removed).
+    // Done with FFTs, far quicker than summing the harmonics, which matters for files of many frames.
+    void setFrame(const int frame, const float* cycle);
+
+    // Level that is alias-free for a phase increment (frequency / sample rate) of phaseDelta
+    static int getLevelForPhaseDelta(const float phaseDelta) noexcept;
+
+    // tableSize + 1 samples, the last one repeats the first so interpolation never has to wrap
+    const float* getLevel(const int level, const int frame = 0) const noexcept
+    {
+        return tables.data() + getOffset(level, frame);
+    }
+
+    // Linearly interpolated value at phase (0..1)
+    static float lookup(const float* level, const float phase) noexcept
+    {
+        const float position = phase * static_cast<float>(tableSize);
+        const int index = static_cast<int>(position);
+        const float fraction = position - static_cast<float>(index);
+        return level[index] + fraction * (level[index + 1] - level[index]);
+    }
+
+private:
+    static size_t getOffset(const int level, const int frame) noexcept
+    {
+        return static_cast<size_t>(frame) * frameSize + static_cast<size_t>(level) * (tableSize + 1);
+    }
+
+    int numFrames = 1;
+    std::vector<float> tables; // numFrames frames of numLevels levels of tableSize + 1 samples
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Wavetable)
+};
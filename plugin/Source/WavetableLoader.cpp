@@ -0,0 +1,256 @@
+/*
+  ==============================================================================
+
+    WavetableLoader.cpp
+    Created: 17 Oct 2026 10:41:07pm
+    Author:  max
+
+  ==============================================================================
+*/
+
+#include "WavetableLoader.h"
+
+namespace
+{
+    constexpr int minCycleLength = 8;
+    constexpr int retireIntervalMs = 500;
+
+    // A run of whole frames, or one cycle short enough to be one (anything else is a sample, not a wavetable)
+    bool isWavetableLength(const juce::int64 length) noexcept
+    {
+        return length >= minCycleLength && (length % Wavetable::tableSize == 0 || length <= WavetableLoader::maxCycleLength);
+    }
+
+    // Fourier series of one cycle of any length, up to the harmonics a Wavetable can hold
+    void analyseCycle(const float* cycle, const int length, const float gain, std::vector<float>& sines, std::vector<float>& cosines)
+    {
+        const int numHarmonics = juce::jmin((length - 1) / 2, Wavetable::maxHarmonics);
+        sines.assign(static_cast<size_t>(numHarmonics), 0.0f);
+        cosines.assign(static_cast<size_t>(numHarmonics), 0.0f);
+
+        // cos(2pi k n / length) and sin(2pi k n / length) are lookups at (k n) mod length
+        std::vector<double> cosineCycle(static_cast<size_t>(length)), sineCycle(static_cast<size_t>(length));
+
+        for (int n = 0; n < length; ++n)
+        {
+            const auto angle = juce::MathConstants<double>::twoPi * n / length;
+            cosineCycle[static_cast<size_t>(n)] = std::cos(angle);
+            sineCycle[static_cast<size_t>(n)] = std::sin(angle);
+        }
+
+        const auto scale = 2.0 * gain / length;
+
+        for (int k = 1; k <= numHarmonics; ++k)
+        {
+            double sine = 0.0, cosine = 0.0;
+
+            for (int n = 0, index = 0; n < length; ++n, index = (index + k) % length)
+            {
+                sine += cycle[n] * sineCycle[static_cast<size_t>(index)];
+                cosine += cycle[n] * cosineCycle[static_cast<size_t>(index)];
+            }
+
+            sines[static_cast<size_t>(k - 1)] = static_cast<float>(sine * scale);
+            cosines[static_cast<size_t>(k - 1)] = static_cast<float>(cosine * scale);
+        }
+    }
+
+    // Reads the frames (or the single cycle) and builds their mip levels, normalised to a peak of 1.
+    // Returns nothing for a silent file, or if shouldStop says so between frames.
+    template <typename StopCheck>
+    std::shared_ptr<const Wavetable> buildWavetable(juce::AudioFormatReader& reader, StopCheck&& shouldStop)
+    {
+        const auto length = reader.lengthInSamples;
+        juce::Range<float> range;
+        reader.readMaxLevels(0, length, &range, 1);
+
+        const float peak = juce::jmax(std::abs(range.getStart()), std::abs(range.getEnd()));
+
+        if (peak <= 0.0f)
+            return nullptr;
+
+        if (length % Wavetable::tableSize != 0)
+        {
+            const int cycleLength = static_cast<int>(length);
+            juce::AudioBuffer<float> cycle(1, cycleLength);
+            reader.read(&cycle, 0, cycleLength, 0, true, false);
+
+            std::vector<float> sines, cosines;
+            analyseCycle(cycle.getReadPointer(0), cycleLength, 1.0f / peak, sines, cosines);
+
+            auto table = std::make_shared<Wavetable>();
+            table->setHarmonics(sines, cosines);
+            return table;
+        }
+
+        const int numFrames = static_cast<int>(juce::jmin(static_cast<juce::int64>(Wavetable::maxFrames), length / Wavetable::tableSize));
+        auto table = std::make_shared<Wavetable>(numFrames);
+        juce::AudioBuffer<float> cycle(1, Wavetable::tableSize);
+
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            if (shouldStop())
+                return nullptr;
+
+            reader.read(&cycle, 0, Wavetable::tableSize, static_cast<juce::int64>(frame) * Wavetable::tableSize, true, false);
+            cycle.applyGain(1.0f / peak);
+            table->setFrame(frame, cycle.getReadPointer(0));
+        }
+
+        return table;
+    }
+}
+
+//==============================================================================
+std::shared_ptr<const Wavetable> WavetableLibrary::find(const juce::String& key)
+{
+    const juce::ScopedLock sl(lock);
+    const auto entry = tables.find(key);
+    return entry != tables.end() ? entry->second.lock() : nullptr;
+}
+
+void WavetableLibrary::add(const juce::String& key, const std::shared_ptr<const Wavetable>& table)
+{
+    const juce::ScopedLock sl(lock);
+
+    // Drop the entries no instance uses any more
+    for (auto entry = tables.begin(); entry != tables.end();)
+        entry = entry->second.expired() ? tables.erase(entry) : std::next(entry);
+
+    tables[key] = table;
+}
+
+juce::String WavetableLibrary::makeKey(const juce::File& file)
+{
+    return file.getFullPathName() + "|" + juce::String(file.getSize()) + "|" + juce::String(file.getLastModificationTime().toMilliseconds());
+}
+
+//==============================================================================
+class WavetableLoader::BuildJob : public juce::ThreadPoolJob
+{
+public:
+    BuildJob(WavetableLoader& loader, const int osc, const int loadGeneration, const juce::String& libraryKey,
+             std::unique_ptr<juce::MemoryMappedAudioFormatReader> mappedReader)
+        : juce::ThreadPoolJob("Wavetable build"),
+          owner(loader),
+          oscIndex(osc),
+          generation(loadGeneration),
+          key(libraryKey),
+          reader(std::move(mappedReader))
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        if (auto table = buildWavetable(*reader, [this] { return shouldExit(); }))
+        {
+            owner.library->add(key, table);
+            owner.publish(oscIndex, generation, std::move(table));
+        }
+
+        return jobHasFinished;
+    }
+
+    const WavetableLoader& getOwner() const noexcept { return owner; }
+
+private:
+    WavetableLoader& owner;
+    const int oscIndex;
+    const int generation;
+    const juce::String key;
+    std::unique_ptr<juce::MemoryMappedAudioFormatReader> reader; // Keeps the file mapped until the job is done
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BuildJob)
+};
+
+//==============================================================================
+WavetableLoader::WavetableLoader()
+{
+    startTimer(retireIntervalMs);
+}
+
+WavetableLoader::~WavetableLoader()
+{
+    stopTimer();
+
+    // Jobs call back into this loader, so ours have to be gone (other instances' can carry on)
+    struct OwnJobs : public juce::ThreadPool::JobSelector
+    {
+        explicit OwnJobs(const WavetableLoader& loader) : owner(loader) {}
+
+        bool isJobSuitable(juce::ThreadPoolJob* job) override
+        {
+            auto* buildJob = dynamic_cast<BuildJob*>(job);
+            return buildJob != nullptr && &buildJob->getOwner() == &owner;
+        }
+
+        const WavetableLoader& owner;
+    };
+
+    OwnJobs ownJobs(*this);
+    library->getThreadPool().removeAllJobs(true, -1, &ownJobs);
+}
+
+bool WavetableLoader::load(const int oscIndex, const juce::File& file)
+{
+    jassert(oscIndex >= 1 && oscIndex <= VoiceBank::numOscillators);
+    const auto key = WavetableLibrary::makeKey(file);
+
+    int generation;
+    {
+        const juce::ScopedLock sl(lock);
+        generation = ++generations[oscIndex - 1];
+    }
+
+    if (auto table = library->find(key))
+    {
+        publish(oscIndex, generation, std::move(table));
+        return true;
+    }
+
+    // Only the header is read here, the samples are paged in by the build job
+    std::unique_ptr<juce::MemoryMappedAudioFormatReader> reader(juce::WavAudioFormat().createMemoryMappedReader(file));
+
+    if (reader == nullptr || !isWavetableLength(reader->lengthInSamples) || !reader->mapEntireFile())
+        return false;
+
+    library->getThreadPool().addJob(new BuildJob(*this, oscIndex, generation, key, std::move(reader)), true);
+    return true;
+}
+
+void WavetableLoader::applyPendingTables(VoiceBank& voiceBank) noexcept
+{
+    for (int osc = 0; osc < VoiceBank::numOscillators; ++osc)
+        if (auto* table = pendingTables[osc].exchange(nullptr))
+            voiceBank.setUserWavetable(osc + 1, table);
+
+    blockCounter.fetch_add(1);
+}
+
+void WavetableLoader::publish(const int oscIndex, const int generation, std::shared_ptr<const Wavetable> table)
+{
+    const juce::ScopedLock sl(lock);
+    const int osc = oscIndex - 1;
+
+    if (generation != generations[osc])
+        return;
+
+    auto previous = std::move(currentTables[osc]);
+    currentTables[osc] = std::move(table);
+    pendingTables[osc].store(currentTables[osc].get());
+
+    // The block running now may still play the previous table and the next one starts by
+    // swapping it out, so it is unused once the counter has moved on twice from here
+    if (previous != nullptr)
+        retiredTables.push_back({ std::move(previous), blockCounter.load() + 2 });
+}
+
+void WavetableLoader::timerCallback()
+{
+    const auto blocksStarted = blockCounter.load();
+    const juce::ScopedLock sl(lock);
+
+    retiredTables.erase(std::remove_if(retiredTables.begin(), retiredTables.end(),
+                                       [blocksStarted] (const RetiredTable& retired) { return blocksStarted >= retired.freeAtBlock; }),
+                        retiredTables.end());
+}
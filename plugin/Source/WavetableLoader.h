@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    WavetableLoader.h
+    Created: 17 Oct 2026 10:41:07pm
+    Author:  max
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Wavetable.h"
+#include "VoiceBank.h"
+
+// The user wavetables of all plugin instances, plus the thread that builds them. Shared
+// through juce::SharedResourcePointer, so a file loaded by several instances is built and
+// kept in memory once.
+class WavetableLibrary
+{
+public:
+    WavetableLibrary() = default;
+
+    // The table built from a file, if some instance is still using it. Keys come from makeKey.
+    std::shared_ptr<const Wavetable> find(const juce::String& key);
+    void add(const juce::String& key, const std::shared_ptr<const Wavetable>& table);
+
+    // Path, size and modification time, so an edited file is built again
+    static juce::String makeKey(const juce::File& file);
+
+    juce::ThreadPool& getThreadPool() noexcept { return threadPool; }
+
+private:
+    juce::CriticalSection lock;
+    std::map<juce::String, std::weak_ptr<const Wavetable>> tables;
+    juce::ThreadPool threadPool { 1 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WavetableLibrary)
+};
+
+// Loads WAV files into the oscillators' wavetable slots. A file holds either frames of
+// Wavetable::tableSize samples (the layout Serum and most other wavetable synths export) or
+// a single cycle of any length up to maxCycleLength. Only the first channel is used.
+//
+// The file is memory mapped instead of read into memory, its mip levels are built on the
+// library's background thread, and the finished table reaches the audio thread through an
+// atomic pointer: processBlock never waits on the disk, a lock or an allocation. Tables the
+// audio thread may still be playing are kept until it has started two more blocks.
+class WavetableLoader : private juce::Timer
+{
+public:
+    static constexpr int maxCycleLength = 4 * Wavetable::tableSize;
+
+    WavetableLoader();
+    ~WavetableLoader() override;
+
+    // Message thread. Starts loading a file for an oscillator (1-based), which keeps playing its
+    // old table until the new one is ready. False if the file isn't a WAV wavetable.
+    bool load(const int oscIndex, const juce::File& file);
+
+    // Audio thread, at the start of every block: gives the voice bank the tables that are ready
+    void applyPendingTables(VoiceBank& voiceBank) noexcept;
+
+private:
+    class BuildJob;
+
+    struct RetiredTable
+    {
+        std::shared_ptr<const Wavetable> table;
+        juce::uint64 freeAtBlock; // Value of blockCounter from which the audio thread can't be using it
+    };
+
+    // Any thread. Makes table the oscillator's current one, unless a newer load has started since.
+    void publish(const int oscIndex, const int generation, std::shared_ptr<const Wavetable> table);
+
+    // Frees the retired tables the audio thread is done with
+    void timerCallback() override;
+
+    juce::SharedResourcePointer<WavetableLibrary> library;
+
+    juce::CriticalSection lock; // Guards the members below the atomics, never taken on the audio thread
+    std::atomic<const Wavetable*> pendingTables[VoiceBank::numOscillators] {};
+    std::atomic<juce::uint64> blockCounter { 0 };
+    std::shared_ptr<const Wavetable> currentTables[VoiceBank::numOscillators];
+    int generations[VoiceBank::numOscillators] = {}; // Counts the loads per oscillator, so a slow build can't replace a newer file
+    std::vector<RetiredTable> retiredTables;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WavetableLoader)
+};